@@ -16,30 +16,35 @@
 // the incorrect reading at a certain probability p. noiseVal (double in [0,1])
 // represents this error probability p.
 // Note: to achieve an algorithm with zero noise, use mode="e" and noiseVal=0.
+//
+// Particles look for others in their field of vision using an index of all
+// particles' heads shared through their system (see core/sectorindex.h), so
+// an activation takes logarithmic instead of linear time in the system size.
 
 #ifndef AMOEBOTSIM_ALG_AGGREGATION_H
 #define AMOEBOTSIM_ALG_AGGREGATION_H
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/sectorindex.h"
+#include "core/typedamoebotsystem.h"
 
 class AggregateParticle : public AmoebotParticle {
   friend class ConvexHullMeasure;
   friend class SEDMeasure;
   friend class DispersionMeasure;
-  friend class ClusterFractionMeasure;
 
  public:
   // Constructs a new particle with a node position for its head, a global
   // compass direction from its head to its tail (-1 if contracted), an offset
   // for its local compass, a system which it belongs to, the direction of the
   // center of rotation for the particle, the form of noise being used, the
-  // amount/value of the noise, and a list containing all of the particles
-  // currently within the system.
+  // amount/value of the noise, and the index of the heads of all particles
+  // in the system, which the particle keeps up to date as it moves.
   AggregateParticle(const Node head, const int globalTailDir, const int
                     orientation, AmoebotSystem& system, int center,
                     const QString mode, const double noiseVal,
-                    std::vector<AggregateParticle*> particles);
+                    SectorIndex& headIndex);
 
   // Executes one particle activation.
   virtual void activate();
@@ -72,19 +77,17 @@ class AggregateParticle : public AmoebotParticle {
   int center;
   QString mode;
   double noiseVal;
-  std::vector<AggregateParticle*> particles;
+  SectorIndex& headIndex;
   int perturb;
-  bool visited;
 
  private:
   friend class AggregateSystem;
 };
 
-class AggregateSystem : public AmoebotSystem  {
+class AggregateSystem : public TypedAmoebotSystem<AggregateParticle> {
   friend class SEDMeasure;
   friend class ConvexHullMeasure;
   friend class DispersionMeasure;
-  friend class ClusterFractionMeasure;
 
  public:
   // Constructs a system of AggregateParticles with an optionally specified size
@@ -97,49 +100,31 @@ class AggregateSystem : public AmoebotSystem  {
   bool hasTerminated() const override;
 
  private:
-  // Depth-first search (DFS) used in the cluster fraction metric.
-  void DFS(AggregateParticle& particle, const AggregateSystem& system,
-           std::vector<AggregateParticle>& clusterVec);
+  // The heads of all particles, shared by them for checkIfParticleInSight.
+  SectorIndex headIndex;
 };
 
-// Returns the Euclidian distance between two points.
-double dist(const QVector<double> a, const QVector<double> b);
-
-/* Copyright (c) 2020 Project Nayuki
- * https://www.nayuki.io/page/smallest-enclosing-circle
- * This program is free software: you can redistribute it and/or modify it under
- * the terms of the GNU Lesser General Public License as published by the Free
- * Software Foundation, either version 3 of the License, or (at your option) any
- * later version.
- * This program is distributed in the hope that it will be useful, but WITHOUT
- * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
- * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
- * details.
- * You should have received a copy of the GNU Lesser General Public License
- * along with this program (see COPYING.txt and COPYING.LESSER.txt).
- * If not, see <http://www.gnu.org/licenses/>. */
-
-// Helper functions for SEDMeasure.
-struct Circle;
-bool isInside(const Circle& c, const QVector<double> p);
-Circle circleFromThree(const QVector<double> a, const QVector<double> b,
-                       const QVector<double> c);
-Circle circleFromTwo(const QVector<double> a, const QVector<double> b);
-bool isValidCircle(const Circle& c, const QVector< QVector<double> > points);
-
-// Returns the circumference of the smallest enclosing disc (SED) of the system.
+// Returns the circumference of the smallest enclosing disc (SED) of the system
+// (see core/geometry.h). With warmStart, each calculation starts from the nodes
+// that defined the previous disc, which usually define the next one as well
+// since particles move little between calculations.
 class SEDMeasure : public Measure {
  public:
   SEDMeasure(const QString name, const unsigned int freq,
-             AggregateSystem& system);
+             AggregateSystem& system, const bool warmStart = true);
 
   double calculate() const final;
 
  protected:
   AggregateSystem& _system;
+  const bool _warmStart;
+
+  // The nodes defining the last calculated disc.
+  mutable std::vector<Node> _support;
 };
 
-// Returns the perimeter of the convex hull of the system.
+// Returns the perimeter of the convex hull of the system, computed exactly on
+// the lattice (see core/geometry.h).
 class ConvexHullMeasure : public Measure {
  public:
   ConvexHullMeasure(const QString name, const unsigned int freq,
@@ -5,6 +5,7 @@
 #include "alg/compression.h"
 
 #include <algorithm>  // For distance() and find().
+#include <cmath>
 #include <set>
 #include <vector>
 
@@ -14,12 +15,14 @@ CompressionParticle::CompressionParticle(const Node head,
                                          const int globalTailDir,
                                          const int orientation,
                                          AmoebotSystem& system,
-                                         const double lambda)
+                                         const double lambda,
+                                         PerimeterMeasure& perimeter)
   : AmoebotParticle(head, globalTailDir, orientation, system),
     lambda(lambda),
     q(0),
     numNbrsBefore(0),
-    flag(false) {}
+    flag(false),
+    perimeter(perimeter) {}
 
 void CompressionParticle::activate() {
   if (isContracted()) {
@@ -28,7 +31,7 @@ void CompressionParticle::activate() {
 
     if (canExpand(expandDir) && !hasExpNbr()) {
       // Count neighbors in original position and expand.
-      numNbrsBefore = nbrCount(uniqueLabels());
+      numNbrsBefore = numLabelsIn(countedNbrMask());
       expand(expandDir);
       flag = !hasExpNbr();
     }
@@ -36,19 +39,16 @@ void CompressionParticle::activate() {
     if (!flag || numNbrsBefore == 5) {
       contractHead();
     } else {
-      // Count neighbors in new position and compute the set S.
-      int numNbrsAfter = nbrCount(headLabels());
-      std::vector<int> S;
-      for (const int label : {headLabels()[4], tailLabels()[4]}) {
-        if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
-          S.push_back(label);
-        }
-      }
+      // Look up the number of neighbors in the new position and whether
+      // Properties 1 or 2 hold for the current neighborhood.
+      const ContractionRule& rule = contractionRule();
 
       // If the conditions are satisfied, contract to the new position;
-      // otherwise, contract back to the original one.
-      if ((q < pow(lambda, numNbrsAfter - numNbrsBefore))
-          && (checkProp1(S) || checkProp2(S))) {
+      // otherwise, contract back to the original one. Only the former changes
+      // the neighboring pairs, trading the tail's neighbors for the head's.
+      if ((q < pow(lambda, rule.numHeadNbrs - numNbrsBefore))
+          && rule.satisfiesProps) {
+        perimeter.record({rule.numHeadNbrs - rule.numTailNbrs});
         contractTail();
       } else {
         contractHead();
@@ -87,8 +87,13 @@ CompressionParticle& CompressionParticle::nbrAtLabel(int label) const {
 }
 
 bool CompressionParticle::hasExpNbr() const {
+  const int nbrs = nbrLabelMask();
+  if (nbrs == 0) {
+    return false;
+  }
+
   for (const int label: uniqueLabels()) {
-    if (hasNbrAtLabel(label) && nbrAtLabel(label).isExpanded()) {
+    if (((nbrs >> label) & 1) && nbrAtLabel(label).isExpanded()) {
       return true;
     }
   }
@@ -96,31 +101,104 @@ bool CompressionParticle::hasExpNbr() const {
   return false;
 }
 
-bool CompressionParticle::hasExpHeadAtLabel(const int label) const {
-  return hasNbrAtLabel(label) && nbrAtLabel(label).isExpanded()
-         && nbrAtLabel(label).pointsAtMyHead(*this, label);
+int CompressionParticle::countedNbrMask() const {
+  return nbrLabelMask() & ~expHeadLabelMask();
 }
 
 int CompressionParticle::nbrCount(std::vector<int> labels) const {
+  const int nbrs = countedNbrMask();
   int numNbrs = 0;
   for (const int label : labels) {
-    if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
-      ++numNbrs;
-    }
+    numNbrs += (nbrs >> label) & 1;
   }
 
   return numNbrs;
 }
 
-bool CompressionParticle::checkProp1(std::vector<int> S) const {
+const CompressionParticle::ContractionRule&
+CompressionParticle::contractionRule() const {
   Q_ASSERT(isExpanded());
+
+  const ContractionTable& table = contractionTable();
+  const std::array<int, 8>& ringLabels = table.ringLabels[tailDir()];
+  const int nbrs = countedNbrMask();
+  int ring = 0;
+  for (int i = 0; i < 8; ++i) {
+    ring |= ((nbrs >> ringLabels[i]) & 1) << i;
+  }
+
+  return table.rules[tailDir()][ring];
+}
+
+const CompressionParticle::ContractionTable&
+CompressionParticle::contractionTable() {
+  static const ContractionTable table = makeContractionTable();
+  return table;
+}
+
+CompressionParticle::ContractionTable
+CompressionParticle::makeContractionTable() {
+  ContractionTable table;
+  for (int tailDir = 0; tailDir < 6; ++tailDir) {
+    // With orientation 0, local and global directions coincide.
+    const LocalParticle shape(Node(0, 0), tailDir, 0);
+    const std::vector<int> labels = shape.uniqueLabels();
+    Q_ASSERT(labels.size() == 8);
+    std::copy(labels.begin(), labels.end(),
+              table.ringLabels[tailDir].begin());
+
+    // Find the position in the ring of the node reached via each label; the
+    // two nodes adjacent to both head and tail are reached via two labels.
+    std::array<int, 10> ringPos;
+    for (int label = 0; label < 10; ++label) {
+      for (int i = 0; i < 8; ++i) {
+        if (shape.nbrNodeReachedViaLabel(label) ==
+            shape.nbrNodeReachedViaLabel(labels[i])) {
+          ringPos[label] = i;
+        }
+      }
+    }
+
+    for (int ring = 0; ring < 256; ++ring) {
+      int nbrs = 0;
+      for (int label = 0; label < 10; ++label) {
+        nbrs |= ((ring >> ringPos[label]) & 1) << label;
+      }
+
+      int numHeadNbrs = 0, numTailNbrs = 0;
+      for (const int label : shape.headLabels()) {
+        numHeadNbrs += (nbrs >> label) & 1;
+      }
+      for (const int label : shape.tailLabels()) {
+        numTailNbrs += (nbrs >> label) & 1;
+      }
+      std::vector<int> S;
+      for (const int label : {shape.headLabels()[4], shape.tailLabels()[4]}) {
+        if ((nbrs >> label) & 1) {
+          S.push_back(label);
+        }
+      }
+
+      ContractionRule& rule = table.rules[tailDir][ring];
+      rule.numHeadNbrs = static_cast<unsigned char>(numHeadNbrs);
+      rule.numTailNbrs = static_cast<unsigned char>(numTailNbrs);
+      rule.satisfiesProps = checkProp1(shape, nbrs, S) ||
+                            checkProp2(shape, nbrs, S);
+    }
+  }
+
+  return table;
+}
+
+bool CompressionParticle::checkProp1(const LocalParticle& shape, int nbrs,
+                                     const std::vector<int>& S) {
+  Q_ASSERT(shape.isExpanded());
   Q_ASSERT(S.size() <= 2);
-  Q_ASSERT(flag);  // Not required, but equivalent/cleaner for implementation.
 
   if (S.size() == 0) {
     return false;  // S has to be nonempty for Property 1.
   } else {
-    const std::vector<int> labels = uniqueLabels();
+    const std::vector<int> labels = shape.uniqueLabels();
     std::set<int> adjNbrs;
 
     // Starting from the particles in S, sweep out and mark connected neighbors.
@@ -132,7 +210,7 @@ bool CompressionParticle::checkProp1(std::vector<int> S) const {
       // expanded head is encountered.
       for (uint offset = 1; offset < labels.size(); ++offset) {
         int label = labels[(i + offset) % labels.size()];
-        if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
+        if ((nbrs >> label) & 1) {
           adjNbrs.insert(label);
         } else {
           break;
@@ -142,7 +220,7 @@ bool CompressionParticle::checkProp1(std::vector<int> S) const {
       // Then sweep clockwise.
       for (uint offset = 1; offset < labels.size(); ++offset) {
         int label = labels[(i - offset + labels.size()) % labels.size()];
-        if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
+        if ((nbrs >> label) & 1) {
           adjNbrs.insert(label);
         } else {
           break;
@@ -153,26 +231,35 @@ bool CompressionParticle::checkProp1(std::vector<int> S) const {
     // If all neighbors are connected to a particle in S by a path through the
     // neighborhood, then the number of labels in adjNbrs should equal the total
     // number of neighbors.
-    return adjNbrs.size() == (uint)nbrCount(labels);
+    uint numNbrs = 0;
+    for (const int label : labels) {
+      numNbrs += (nbrs >> label) & 1;
+    }
+    return adjNbrs.size() == numNbrs;
   }
 }
 
-bool CompressionParticle::checkProp2(std::vector<int> S) const {
-  Q_ASSERT(isExpanded());
+bool CompressionParticle::checkProp2(const LocalParticle& shape, int nbrs,
+                                     const std::vector<int>& S) {
+  Q_ASSERT(shape.isExpanded());
   Q_ASSERT(S.size() <= 2);
-  Q_ASSERT(flag);  // Not required, but equivalent/cleaner for implementation.
 
   if (S.size() != 0) {
     return false;  // S has to be empty for Property 2.
   } else {
-    const int numHeadNbrs = nbrCount(headLabels());
-    const int numTailNbrs = nbrCount(tailLabels());
+    int numHeadNbrs = 0, numTailNbrs = 0;
+    for (const int label : shape.headLabels()) {
+      numHeadNbrs += (nbrs >> label) & 1;
+    }
+    for (const int label : shape.tailLabels()) {
+      numTailNbrs += (nbrs >> label) & 1;
+    }
 
     // Check if the head's neighbors are connected.
     int numAdjHeadNbrs = 0;
     bool seenNbr = false;
-    for (const int label : headLabels()) {
-      if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
+    for (const int label : shape.headLabels()) {
+      if ((nbrs >> label) & 1) {
         seenNbr = true;
         ++numAdjHeadNbrs;
       } else if (seenNbr) {
@@ -183,8 +270,8 @@ bool CompressionParticle::checkProp2(std::vector<int> S) const {
     // Check if the tail's neighbors are connected.
     int numAdjTailNbrs = 0;
     seenNbr = false;
-    for (const int label : tailLabels()) {
-      if (hasNbrAtLabel(label) && !hasExpHeadAtLabel(label)) {
+    for (const int label : shape.tailLabels()) {
+      if ((nbrs >> label) & 1) {
         seenNbr = true;
         ++numAdjTailNbrs;
       } else if (seenNbr) {
@@ -199,11 +286,30 @@ bool CompressionParticle::checkProp2(std::vector<int> S) const {
   }
 }
 
-
-CompressionSystem::CompressionSystem(int numParticles, double lambda) {
+CompressionSystem::CompressionSystem(int numParticles, double lambda,
+                                     bool verifyPerimeter)
+  : perimeter(new PerimeterMeasure("Perimeter", 1, *this)),
+    perimeterMismatchCount(verifyPerimeter
+                           ? &addCount("# Perimeter Mismatches") : nullptr) {
   Q_ASSERT(lambda > 1);
 
+  // Set up metrics first, as the particles record to the perimeter directly.
+  _measures.push_back(perimeter);
+
   // Initialize particle system.
+  for (const Node& node : initialNodes(numParticles, lambda)) {
+    insert(newParticle<CompressionParticle>(node, -1, randDir(), *this,
+                                            lambda, *perimeter));
+  }
+
+  // The particles only record changes, so count the initial pairs once.
+  perimeter->record({perimeter->countNbrPairs()});
+}
+
+std::vector<Node> CompressionSystem::initialNodes(int numParticles,
+                                                  double lambda) {
+  std::vector<Node> nodes;
+  nodes.reserve(numParticles);
   if (lambda <= 2.17) {  // In the proven range of expansion, make a hexagon.
     int x, y;
     for (int i = 1; i <= numParticles; ++i) {
@@ -248,45 +354,56 @@ CompressionSystem::CompressionSystem(int numParticles, double lambda) {
         }
       }
 
-      insert(new CompressionParticle(Node(x, y), -1, randDir(), *this, lambda));
+      nodes.push_back(Node(x, y));
     }
   } else {  // In the unknown range or compression range, make a straight line.
     for (int i = 0; i < numParticles; ++i) {
-      insert(new CompressionParticle(Node(i, 0), -1, randDir(), *this, lambda));
+      nodes.push_back(Node(i, 0));
     }
   }
 
-  // Set up metrics.
-  _measures.push_back(new PerimeterMeasure("Perimeter", 1, *this));
+  return nodes;
 }
 
 bool CompressionSystem::hasTerminated() const {
   #ifdef QT_DEBUG
-    if (!isConnected(particles)) {
+    if (!isConnected()) {
         return true;
     }
   #endif
 
+  if (perimeterMismatchCount != nullptr) {
+    // Stop recounting once a mismatch has been recorded, as the system is
+    // reported as terminated from then on.
+    if (perimeterMismatchCount->_value == 0 &&
+        perimeter->sums()[0] != perimeter->countNbrPairs()) {
+      perimeterMismatchCount->record();
+    }
+    return perimeterMismatchCount->_value > 0;
+  }
+
   return false;
 }
 
 PerimeterMeasure::PerimeterMeasure(const QString name, const unsigned int freq,
                                    CompressionSystem& system)
-    : Measure(name, freq),
+    : IncrementalMeasure(name, freq),
       _system(system) {}
 
-double PerimeterMeasure::calculate() const {
-  int numEdges = 0;
-  for (const auto& p : _system.particles) {
-    auto comp_p = dynamic_cast<CompressionParticle*>(p);
+int64_t PerimeterMeasure::countNbrPairs() const {
+  int64_t numEdges = 0;
+  for (auto comp_p : _system.typedParticles()) {
     auto tailLabels = comp_p->isContracted() ? comp_p->uniqueLabels()
                                              : comp_p->tailLabels();
+    const int nbrs = comp_p->countedNbrMask();
     for (const int label : tailLabels) {
-      if (comp_p->hasNbrAtLabel(label) && !comp_p->hasExpHeadAtLabel(label)) {
-        ++numEdges;
-      }
+      numEdges += (nbrs >> label) & 1;
     }
   }
 
-  return (3 * _system.size()) - (numEdges / 2) - 3;
+  return numEdges / 2;
+}
+
+double PerimeterMeasure::value(const Sums& sums) const {
+  return (3 * static_cast<int64_t>(_system.size())) - sums[0] - 3;
 }
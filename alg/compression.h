@@ -7,26 +7,44 @@
 // Self-Organizing Particle Systems' [arxiv.org/abs/1603.07991]. In particular,
 // this simulates the local, distributed, asynchronous algorithm A using the
 // #neighbors metric instead of the #triangles metric.
+//
+// The system's perimeter is tracked incrementally: it is determined by the
+// number of neighboring pairs of particles (see PerimeterMeasure), which only
+// changes when a particle contracts its tail, and then only by the difference
+// between its neighbors at its new and old positions. These are known from the
+// ContractionTable lookup the particle makes anyway, so keeping the count up to
+// date costs nothing, and the measure no longer scans the whole system.
 
 #ifndef AMOEBOTSIM_ALG_COMPRESSION_H_
 #define AMOEBOTSIM_ALG_COMPRESSION_H_
 
+#include <array>
+#include <vector>
+
 #include <QString>
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/localparticle.h"
+#include "core/metric.h"
+#include "core/node.h"
+#include "core/typedamoebotsystem.h"
+
+class PerimeterMeasure;
 
 class CompressionParticle : public AmoebotParticle {
+  friend class BitboardCompressionSystem;
   friend class CompressionSystem;
   friend class PerimeterMeasure;
 
  public:
   // Constructs a new particle with a node position for its head, a global
   // compass direction from its head to its tail (-1 if contracted), an offset
-  // for its local compass, a system which it belongs to, and a bias parameter.
+  // for its local compass, a system which it belongs to, a bias parameter, and
+  // the system's perimeter measure to record to.
   CompressionParticle(const Node head, const int globalTailDir,
                       const int orientation, AmoebotSystem& system,
-                      const double lambda);
+                      const double lambda, PerimeterMeasure& perimeter);
 
   // Executes one particle activation.
   virtual void activate();
@@ -48,48 +66,103 @@ private:
   // hasNbrAtLabel() first if unsure.
   CompressionParticle& nbrAtLabel(int label) const;
 
-  // hasExpNbr() checks whether this particle has an expanded neighbor, while
-  // hasExpHeadAtLabel() checks whether the head of an expanded neighbor is at
-  // the position at the specified label.
+  // Checks whether this particle has an expanded neighbor.
   bool hasExpNbr() const;
-  bool hasExpHeadAtLabel(const int label) const;
+
+  // Returns the mask of labels (see AmoebotParticle::nbrLabelMask) at which
+  // this particle has a neighbor that is not the head of an expanded particle,
+  // i.e., the neighbors counted by nbrCount.
+  int countedNbrMask() const;
 
   // Counts the number of neighbors in the labeled positions. Note: this
   // implicitly assumes all neighbors are unique, as none are expanded.
   int nbrCount(std::vector<int> labels) const;
 
-  // Functions for checking Properties 1 and 2 of the compression algorithm.
-  bool checkProp1(std::vector<int> S) const;
-  bool checkProp2(std::vector<int> S) const;
+  // Whether an expanded particle may contract into its head depends only on
+  // which of the eight nodes around it hold counted neighbors. For each local
+  // tail direction, the ContractionTable lists the labels addressing these
+  // nodes (in the order of uniqueLabels) and, for each of the 256 ways of
+  // occupying them, the numbers of head and tail neighbors and whether
+  // Property 1 or 2 holds. contractionRule looks up the entry for this
+  // particle's current neighborhood.
+  struct ContractionRule {
+    unsigned char numHeadNbrs;
+    unsigned char numTailNbrs;
+    bool satisfiesProps;
+  };
+  struct ContractionTable {
+    std::array<std::array<int, 8>, 6> ringLabels;
+    std::array<std::array<ContractionRule, 256>, 6> rules;
+  };
+  const ContractionRule& contractionRule() const;
+  static const ContractionTable& contractionTable();
+  static ContractionTable makeContractionTable();
+
+  // Functions for checking Properties 1 and 2 of the compression algorithm for
+  // an expanded particle with the given shape (i.e., tail direction) and mask
+  // of labels with counted neighbors. These define the ContractionTable.
+  static bool checkProp1(const LocalParticle& shape, int nbrs,
+                         const std::vector<int>& S);
+  static bool checkProp2(const LocalParticle& shape, int nbrs,
+                         const std::vector<int>& S);
+
+  // The system's perimeter measure, to which this particle records the change
+  // in the number of neighboring pairs when it contracts its tail.
+  PerimeterMeasure& perimeter;
 };
 
-class CompressionSystem : public AmoebotSystem {
+class CompressionSystem : public TypedAmoebotSystem<CompressionParticle> {
   friend class PerimeterMeasure;
 
  public:
   // Constructs a system of CompressionParticles connected to a randomly
   // generated surface (with no tunnels). Takes an optionally specified size
   // (#particles) and a bias parameter. A bias above 2 + sqrt(2) will provably
-  // yield compression; a bias below 2.17 will provably yield expansion.
-  CompressionSystem(int numParticles = 100, double lambda = 4.0);
-
-  // Because this algorithm never terminates, this simply returns false.
+  // yield compression; a bias below 2.17 will provably yield expansion. If
+  // verifyPerimeter is set, the incrementally tracked perimeter is compared
+  // against a full recount after every activation, and mismatches are counted
+  // in "# Perimeter Mismatches" (see hasTerminated).
+  CompressionSystem(int numParticles = 100, double lambda = 4.0,
+                    bool verifyPerimeter = false);
+
+  // Returns the nodes of the initial configuration described above, in the
+  // order in which the particles occupying them are inserted.
+  static std::vector<Node> initialNodes(int numParticles, double lambda);
+
+  // Because this algorithm never terminates, this returns false unless the
+  // system has become disconnected (only checked in debug builds) or, when
+  // verifying the perimeter, the tracked perimeter has differed from a
+  // recount.
   virtual bool hasTerminated() const;
+
+ private:
+  PerimeterMeasure* perimeter;
+
+  // The count of perimeter mismatches when verifying the perimeter, and
+  // nullptr otherwise.
+  Count* perimeterMismatchCount;
 };
 
-class PerimeterMeasure : public Measure {
+class PerimeterMeasure : public IncrementalMeasure<1> {
  public:
   // Constructs a PerimeterMeasure by using the parent constructor and adding a
-  // reference to the CompressionSystem being measured.
+  // reference to the CompressionSystem being measured. Its only sum is the
+  // number of nearest neighbor pairs, where an expanded particle counts at its
+  // tail only; the system records the initial count once all particles are
+  // inserted, and particles record its changes as they move.
   PerimeterMeasure(const QString name, const unsigned int freq,
                    CompressionSystem& system);
 
+  // Counts the nearest neighbor pairs from scratch by probing the neighbors of
+  // every particle, for initializing and verifying the sum.
+  int64_t countNbrPairs() const;
+
+ protected:
   // Calculates the perimeter of the system, i.e., the number of edges on the
   // walk around the unique external boundary of the system. Uses the fact
   // that perimeter = (3 * #particles) - (#nearest neighbor pairs) - 3.
-  double calculate() const final;
+  double value(const Sums& sums) const final;
 
- protected:
   CompressionSystem& _system;
 };
 
@@ -0,0 +1,343 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "alg/compressionbitboard.h"
+
+#include <cmath>
+
+#include <QtGlobal>
+
+#include "core/amoebotparticle.h"
+#include "core/localparticle.h"
+
+BitboardCompressionParticle::BitboardCompressionParticle(const Node& head,
+                                                         const int orientation)
+  : Particle(head, -1),
+    orientation(orientation),
+    q(0),
+    numNbrsBefore(0),
+    flag(false),
+    roundStamp(0) {}
+
+QString BitboardCompressionParticle::inspectionText() const {
+  QString text;
+  text += "Global Info:\n";
+  text += "  head: (" + QString::number(head.x) + ", "
+                      + QString::number(head.y) + ")\n";
+  text += "  orientation: " + QString::number(orientation) + "\n";
+  text += "  globalTailDir: " + QString::number(globalTailDir) + "\n\n";
+  text += "Properties:\n";
+  text += "  q in (0,1) = " + QString::number(q) + ",\n";
+  text += "  flag = " + QString::number(flag) + ",\n";
+  text += "  #neighbors before = " + QString::number(numNbrsBefore) + ".\n";
+
+  return text;
+}
+
+BitboardCompressionSystem::BitboardCompressionSystem(int numParticles,
+                                                     double lambda,
+                                                     bool crossCheck)
+  : lambda(0),
+    roundEpoch(1),
+    numActivatedThisRound(0),
+    roundCount(addCount("# Rounds")),
+    activationCount(addCount("# Activations")),
+    moveCount(addCount("# Moves")),
+    divergenceCount(nullptr) {
+  setLambda(lambda);
+
+  // Draw the particles' orientations in the same order as CompressionSystem.
+  const std::vector<Node> nodes =
+      CompressionSystem::initialNodes(numParticles, lambda);
+  particles.reserve(nodes.size());
+  for (const Node& node : nodes) {
+    particles.emplace_back(node, randDir());
+    particles.back().roundStamp = roundEpoch - 1;
+    lattice.set(occupiedPlane, node);
+  }
+
+  _measures.push_back(new BitboardPerimeterMeasure("Perimeter", 1, *this));
+
+  if (crossCheck) {
+    // Seeds are at most 32 bits (see RandomNumberGenerator::entropySeed), so
+    // they can always be passed on as a default seed.
+    const int64_t previousSeed =
+        setDefaultSeed(static_cast<int64_t>(getSeed()));
+    reference.reset(new CompressionSystem(numParticles, lambda));
+    setDefaultSeed(previousSeed);
+    divergenceCount = &addCount("# Divergences");
+  }
+}
+
+BitboardCompressionSystem::~BitboardCompressionSystem() {
+  for (auto c : _counts) {
+    delete c;
+  }
+
+  for (auto m : _measures) {
+    delete m;
+  }
+}
+
+void BitboardCompressionSystem::activate() {
+  if (particles.size() > 0) {
+    const unsigned int i = randInt(0, particles.size());
+    registerActivation(particles[i]);
+    activateParticle(particles[i]);
+
+    if (reference != nullptr) {
+      reference->activate();
+      crossCheck(i);
+    }
+  }
+}
+
+void BitboardCompressionSystem::activateParticleAt(Node node) {
+  // Only used interactively, so a linear search suffices.
+  for (unsigned int i = 0; i < particles.size(); ++i) {
+    BitboardCompressionParticle& p = particles[i];
+    if (p.head == node || (p.isExpanded() && p.tail() == node)) {
+      registerActivation(p);
+      activateParticle(p);
+
+      if (reference != nullptr) {
+        reference->activateParticleAt(node);
+        crossCheck(i);
+      }
+      return;
+    }
+  }
+}
+
+unsigned int BitboardCompressionSystem::size() const {
+  return particles.size();
+}
+
+unsigned int BitboardCompressionSystem::numObjects() const {
+  return objects.size();
+}
+
+const Particle& BitboardCompressionSystem::at(int i) const {
+  return particles.at(i);
+}
+
+const std::deque<Object*>& BitboardCompressionSystem::getObjects() const {
+  return objects;
+}
+
+const std::vector<Count*>& BitboardCompressionSystem::getCounts() const {
+  return _counts;
+}
+
+const std::vector<Measure*>& BitboardCompressionSystem::getMeasures() const {
+  return _measures;
+}
+
+uint64_t BitboardCompressionSystem::getSeed() const {
+  return RandomNumberGenerator::getSeed();
+}
+
+bool BitboardCompressionSystem::hasTerminated() const {
+  return divergenceCount != nullptr && divergenceCount->_value > 0;
+}
+
+int BitboardCompressionSystem::perimeter() const {
+  // Count the edges between the tail (or only) nodes of particles, which are
+  // exactly the neighbor pairs PerimeterMeasure counts, each twice.
+  int numEdges = 0;
+  for (const auto& p : particles) {
+    const Node node = p.isContracted() ? p.head : p.tail();
+    numEdges += AmoebotParticle::numLabelsIn(countedMask(node, nbrOffsets()));
+  }
+
+  return (3 * particles.size()) - (numEdges / 2) - 3;
+}
+
+double BitboardCompressionSystem::getLambda() const {
+  return lambda;
+}
+
+void BitboardCompressionSystem::setLambda(double lambda) {
+  Q_ASSERT(lambda > 1);
+  Q_ASSERT(reference == nullptr);
+
+  // Computing the powers once yields exactly the values pow would return in
+  // every activation.
+  this->lambda = lambda;
+  for (int k = -5; k <= 5; ++k) {
+    biasPowers[k + 5] = pow(lambda, k);
+  }
+}
+
+void BitboardCompressionSystem::activateParticle(
+    BitboardCompressionParticle& p) {
+  if (p.isContracted()) {
+    const int expandDir = (randDir() + p.orientation) % 6;
+    p.q = randDouble(0, 1);
+
+    if (!lattice.test(occupiedPlane, p.head.nodeInDir(expandDir)) &&
+        lattice.gather(expandedPlane, p.head, nbrOffsets()) == 0) {
+      p.numNbrsBefore =
+          AmoebotParticle::numLabelsIn(countedMask(p.head, nbrOffsets()));
+      expand(p, expandDir);
+      p.flag = lattice.gather(expandedPlane, p.head,
+                              ringOffsets()[p.globalTailDir]) == 0;
+    }
+  } else {  // p.isExpanded().
+    if (!p.flag || p.numNbrsBefore == 5) {
+      contractHead(p);
+    } else {
+      // The contraction table is indexed by local tail direction, but the
+      // rules are invariant under rotation, so the global one works as well.
+      const int ring = countedMask(p.head, ringOffsets()[p.globalTailDir]);
+      const CompressionParticle::ContractionRule& rule =
+          CompressionParticle::contractionTable().rules[p.globalTailDir][ring];
+      if ((p.q < biasPowers[rule.numHeadNbrs - p.numNbrsBefore + 5])
+          && rule.satisfiesProps) {
+        contractTail(p);
+      } else {
+        contractHead(p);
+      }
+    }
+  }
+}
+
+void BitboardCompressionSystem::expand(BitboardCompressionParticle& p,
+                                       int globalDir) {
+  Q_ASSERT(p.isContracted());
+
+  const Node tail = p.head;
+  p.head = p.head.nodeInDir(globalDir);
+  p.globalTailDir = (globalDir + 3) % 6;
+  lattice.set(occupiedPlane, p.head);
+  lattice.set(expandedHeadPlane, p.head);
+  lattice.set(expandedPlane, p.head);
+  lattice.set(expandedPlane, tail);
+
+  moveCount.record();
+}
+
+void BitboardCompressionSystem::contractHead(BitboardCompressionParticle& p) {
+  Q_ASSERT(p.isExpanded());
+
+  lattice.reset(occupiedPlane, p.head);
+  lattice.reset(expandedHeadPlane, p.head);
+  lattice.reset(expandedPlane, p.head);
+  p.head = p.tail();
+  p.globalTailDir = -1;
+  lattice.reset(expandedPlane, p.head);
+
+  moveCount.record();
+}
+
+void BitboardCompressionSystem::contractTail(BitboardCompressionParticle& p) {
+  Q_ASSERT(p.isExpanded());
+
+  lattice.reset(occupiedPlane, p.tail());
+  lattice.reset(expandedPlane, p.tail());
+  lattice.reset(expandedHeadPlane, p.head);
+  lattice.reset(expandedPlane, p.head);
+  p.globalTailDir = -1;
+
+  moveCount.record();
+}
+
+void BitboardCompressionSystem::registerActivation(
+    BitboardCompressionParticle& p) {
+  activationCount.record();
+  if (p.roundStamp != roundEpoch) {
+    p.roundStamp = roundEpoch;
+    ++numActivatedThisRound;
+  }
+  if (numActivatedThisRound == particles.size()) {
+    registerRound();
+    ++roundEpoch;
+    numActivatedThisRound = 0;
+  }
+}
+
+void BitboardCompressionSystem::registerRound() {
+  for (const auto& c : _counts) {
+    c->_history.push_back(c->_value);
+  }
+  for (const auto& m : _measures) {
+    if (roundCount._value % m->_freq == 0) {
+      m->_history.push_back(m->calculate());
+    }
+  }
+  roundCount.record();
+}
+
+Count& BitboardCompressionSystem::addCount(const QString name) {
+  _counts.push_back(new Count(name));
+  return *_counts.back();
+}
+
+void BitboardCompressionSystem::crossCheck(unsigned int i) {
+  Q_ASSERT(reference != nullptr);
+
+  const Particle& p = particles[i];
+  const Particle& r = reference->at(i);
+  bool diverged = p.head != r.head || p.globalTailDir != r.globalTailDir;
+
+  // Rounds end at the same activation in both systems, so the histories
+  // recorded at the end of a round can be compared right away.
+  const Count& referenceRounds = reference->getCount("# Rounds");
+  diverged = diverged || roundCount._value != referenceRounds._value ||
+             moveCount._value != reference->getCount("# Moves")._value;
+  if (!diverged && numActivatedThisRound == 0) {
+    for (unsigned int j = 0; j < particles.size() && !diverged; ++j) {
+      diverged = particles[j].head != reference->at(j).head ||
+                 particles[j].globalTailDir != reference->at(j).globalTailDir;
+    }
+    diverged = diverged || _measures[0]->_history !=
+               reference->getMeasure("Perimeter")._history;
+  }
+
+  if (diverged) {
+    divergenceCount->record();
+  }
+}
+
+const std::array<Node, 6>& BitboardCompressionSystem::nbrOffsets() {
+  static const std::array<Node, 6> offsets = {
+    {Node(1, 0), Node(0, 1), Node(-1, 1), Node(-1, 0), Node(0, -1),
+     Node(1, -1)}
+  };
+
+  return offsets;
+}
+
+const std::array<std::array<Node, 8>, 6>&
+BitboardCompressionSystem::ringOffsets() {
+  static const std::array<std::array<Node, 8>, 6> offsets = makeRingOffsets();
+  return offsets;
+}
+
+std::array<std::array<Node, 8>, 6>
+BitboardCompressionSystem::makeRingOffsets() {
+  const CompressionParticle::ContractionTable& table =
+      CompressionParticle::contractionTable();
+  std::array<std::array<Node, 8>, 6> offsets;
+  for (int tailDir = 0; tailDir < 6; ++tailDir) {
+    // With its head at the origin, the nodes a particle reaches are offsets.
+    const LocalParticle shape(Node(0, 0), tailDir, 0);
+    for (int i = 0; i < 8; ++i) {
+      offsets[tailDir][i] =
+          shape.nbrNodeReachedViaLabel(table.ringLabels[tailDir][i]);
+    }
+  }
+
+  return offsets;
+}
+
+BitboardPerimeterMeasure::BitboardPerimeterMeasure(
+    const QString name, const unsigned int freq,
+    const BitboardCompressionSystem& system)
+    : Measure(name, freq),
+      _system(system) {}
+
+double BitboardPerimeterMeasure::calculate() const {
+  return _system.perimeter();
+}
@@ -0,0 +1,184 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a specialized engine for the Compression Algorithm (see
+// alg/compression.h) for systems of millions of particles, which are far too
+// many for one AmoebotParticle object per particle. The configuration is kept
+// in a bit-packed lattice (see core/bitlattice.h) and the particles in one
+// flat array holding their coordinates and memory. Activations apply the same
+// move rule as CompressionParticle::activate, including its contraction table,
+// and draw the same random numbers in the same order, so an engine seeded like
+// a CompressionSystem simulates the very same chain.
+//
+// The cross-check mode relies on this: it additionally runs a CompressionSystem
+// with the same seed in lockstep, compares the activated particle after every
+// activation and the whole configuration and perimeter after every round, and
+// terminates at the first divergence. It is meant for small inputs only.
+
+#ifndef AMOEBOTSIM_ALG_COMPRESSIONBITBOARD_H_
+#define AMOEBOTSIM_ALG_COMPRESSIONBITBOARD_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <QString>
+
+#include "alg/compression.h"
+#include "core/bitlattice.h"
+#include "core/metric.h"
+#include "core/node.h"
+#include "core/object.h"
+#include "core/particle.h"
+#include "core/system.h"
+#include "helper/randomnumbergenerator.h"
+
+class BitboardCompressionParticle : public Particle {
+ public:
+  // Constructs a new contracted particle with a node position for its head and
+  // an offset for its local compass, as drawn for the corresponding
+  // CompressionParticle.
+  BitboardCompressionParticle(const Node& head, const int orientation);
+
+  // Returns the string to be displayed when this particle is inspected.
+  virtual QString inspectionText() const;
+
+  // Particle memory, mirroring CompressionParticle's. roundStamp serves the
+  // same purpose as AmoebotParticle's.
+  int orientation;
+  double q;
+  int numNbrsBefore;
+  bool flag;
+  unsigned int roundStamp;
+};
+
+class BitboardCompressionSystem : public System, public RandomNumberGenerator {
+ public:
+  // Constructs a system in the same initial configuration as a
+  // CompressionSystem with the given size and bias parameter, optionally
+  // cross-checking it against one.
+  BitboardCompressionSystem(int numParticles = 100, double lambda = 4.0,
+                            bool crossCheck = false);
+
+  // Deletes the metrics (and the cross-checked system, if any).
+  virtual ~BitboardCompressionSystem();
+
+  // Functions for activating a particle in the system; see AmoebotSystem.
+  void activate() final;
+  void activateParticleAt(Node node) final;
+
+  // Functions for accessing the particles and (always empty) object list.
+  unsigned int size() const final;
+  unsigned int numObjects() const final;
+  const Particle& at(int i) const final;
+  const std::deque<Object*>& getObjects() const final;
+
+  // Access functions for metrics and the random number generator's seed; see
+  // AmoebotSystem. In cross-check mode, the counts include "# Divergences".
+  const std::vector<Count*>& getCounts() const final;
+  const std::vector<Measure*>& getMeasures() const final;
+  uint64_t getSeed() const final;
+
+  // The chain never terminates, so this only returns true once the cross-check
+  // has found a divergence.
+  virtual bool hasTerminated() const;
+
+  // Returns the perimeter of the system as defined by PerimeterMeasure.
+  int perimeter() const;
+
+  // Functions for the bias parameter. setLambda changes the bias of every
+  // particle at once, e.g., for replica exchange (see
+  // alg/compressiontempering.h); this is not supported in cross-check mode.
+  double getLambda() const;
+  void setLambda(double lambda);
+
+ private:
+  // The bit planes of the lattice. A node is in expandedPlane if it is
+  // occupied by an expanded particle and additionally in expandedHeadPlane if
+  // it is that particle's head.
+  enum Plane {
+    occupiedPlane,
+    expandedHeadPlane,
+    expandedPlane,
+    numPlanes
+  };
+
+  // Executes one activation of the given particle.
+  void activateParticle(BitboardCompressionParticle& p);
+
+  // Movement functions equivalent to AmoebotParticle's expand, contractHead,
+  // and contractTail, taking global directions.
+  void expand(BitboardCompressionParticle& p, int globalDir);
+  void contractHead(BitboardCompressionParticle& p);
+  void contractTail(BitboardCompressionParticle& p);
+
+  // Returns the mask of the given nodes around the origin holding neighbors
+  // counted by CompressionParticle, i.e., not heads of expanded particles.
+  template<std::size_t N>
+  unsigned int countedMask(const Node& origin,
+                           const std::array<Node, N>& offsets) const;
+
+  // Logging functions equivalent to AmoebotSystem's.
+  void registerActivation(BitboardCompressionParticle& p);
+  void registerRound();
+  Count& addCount(const QString name);
+
+  // Compares the given particle and, if a round was just completed, the whole
+  // system with the cross-checked system, recording any divergence.
+  void crossCheck(unsigned int i);
+
+  // Offsets of the six neighbors of a node and, for each global tail
+  // direction, of the eight neighbors of an expanded particle's head and tail
+  // relative to its head in the order of the contraction table's rings.
+  static const std::array<Node, 6>& nbrOffsets();
+  static const std::array<std::array<Node, 8>, 6>& ringOffsets();
+  static std::array<std::array<Node, 8>, 6> makeRingOffsets();
+
+  double lambda;
+
+  // biasPowers[k + 5] = lambda^k, for the exponents -5 <= k <= 5 the move rule
+  // can produce.
+  std::array<double, 11> biasPowers;
+
+  std::vector<BitboardCompressionParticle> particles;
+  BitLattice<numPlanes> lattice;
+  unsigned int roundEpoch;
+  unsigned int numActivatedThisRound;
+  std::deque<Object*> objects;
+  std::vector<Count*> _counts;
+  std::vector<Measure*> _measures;
+  Count& roundCount;
+  Count& activationCount;
+  Count& moveCount;
+
+  // The system cross-checked against and its count of divergences, or nullptr
+  // if cross-checking is off.
+  std::unique_ptr<CompressionSystem> reference;
+  Count* divergenceCount;
+};
+
+class BitboardPerimeterMeasure : public Measure {
+ public:
+  // Constructs a measure of the perimeter of the given system, equivalent to
+  // PerimeterMeasure.
+  BitboardPerimeterMeasure(const QString name, const unsigned int freq,
+                           const BitboardCompressionSystem& system);
+
+  double calculate() const final;
+
+ protected:
+  const BitboardCompressionSystem& _system;
+};
+
+template<std::size_t N>
+inline unsigned int BitboardCompressionSystem::countedMask(
+    const Node& origin, const std::array<Node, N>& offsets) const {
+  return lattice.gather(occupiedPlane, origin, offsets) &
+         ~lattice.gather(expandedHeadPlane, origin, offsets);
+}
+
+#endif  // AMOEBOTSIM_ALG_COMPRESSIONBITBOARD_H_
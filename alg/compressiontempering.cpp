@@ -0,0 +1,157 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "alg/compressiontempering.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include <QtGlobal>
+
+#include "core/metric.h"
+
+CompressionTempering::CompressionTempering(const int numParticles,
+                                           std::vector<double> lambdas,
+                                           const uint64_t baseSeed,
+                                           const int roundsPerEpoch)
+  : _lambdas(lambdas),
+    _baseSeed(baseSeed),
+    _roundsPerEpoch(roundsPerEpoch),
+    _perimeterHistories(lambdas.size()),
+    _swapAttempts(std::max(static_cast<int>(lambdas.size()) - 1, 0), 0),
+    _swapAccepts(std::max(static_cast<int>(lambdas.size()) - 1, 0), 0),
+    _numEpochs(0),
+    _rng(baseSeed + lambdas.size()) {
+  Q_ASSERT(numParticles > 0);
+  Q_ASSERT(std::is_sorted(lambdas.begin(), lambdas.end()));
+  Q_ASSERT(roundsPerEpoch > 0);
+
+  // Seed replica k with baseSeed + k, as Ensemble does, so that it starts out
+  // exactly like a single run with that seed.
+  for (unsigned int k = 0; k < _lambdas.size(); ++k) {
+    const int64_t previousSeed =
+        RandomNumberGenerator::setDefaultSeed(baseSeed + k);
+    _replicas.emplace_back(
+        new BitboardCompressionSystem(numParticles, _lambdas[k]));
+    RandomNumberGenerator::setDefaultSeed(previousSeed);
+    _replicaAt.push_back(k);
+  }
+}
+
+void CompressionTempering::run(const int numRounds, int numThreads) {
+  if (numThreads <= 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  numThreads = std::min(numThreads, static_cast<int>(_replicas.size()));
+
+  std::vector<int> perimeters(_replicas.size());
+  while (_numEpochs * _roundsPerEpoch < numRounds) {
+    const unsigned int targetRound =
+        std::min(numRounds, (_numEpochs + 1) * _roundsPerEpoch);
+
+    // As in Ensemble::run, idle workers claim the next replica that has not
+    // run this epoch yet.
+    std::atomic<int> nextReplica(0);
+    auto worker = [this, targetRound, &perimeters, &nextReplica]() {
+      for (int i = nextReplica++; i < static_cast<int>(_replicas.size());
+           i = nextReplica++) {
+        BitboardCompressionSystem& replica = *_replicas[i];
+        const Count& rounds = replica.getCount("# Rounds");
+        while (rounds._value < targetRound) {
+          replica.activate();
+        }
+        perimeters[i] = replica.perimeter();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+      threads.emplace_back(worker);
+    }
+    worker();  // The calling thread works too.
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (unsigned int k = 0; k < _lambdas.size(); ++k) {
+      _perimeterHistories[k].push_back(perimeters[_replicaAt[k]]);
+    }
+    attemptSwaps(_numEpochs % 2);
+    ++_numEpochs;
+  }
+}
+
+const QString CompressionTempering::metricsAsJSON() const {
+  QString json = "{\"title\" : \"AmoebotSim Tempering Metrics JSON\", ";
+  json += "\"datetime\" : \"" +
+          QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") + "\", ";
+  json += "\"algorithm\" : \"compression\", ";
+  json += "\"seed\" : " + QString::number(_baseSeed) + ", ";
+  json += "\"epochRounds\" : " + QString::number(_roundsPerEpoch) + ", ";
+  json += "\"lambdas\" : [";
+  for (unsigned int k = 0; k < _lambdas.size(); ++k) {
+    json += "{\"lambda\" : " + QString::number(_lambdas[k]) + ", ";
+    json += "\"perimeter\" : [";
+    for (auto val : _perimeterHistories[k]) {
+      json += QString::number(val) += ", ";
+    }
+    if (!_perimeterHistories[k].empty()) {
+      json.chop(2);  // Remove the last ", ".
+    }
+    json += "]}, ";
+  }
+  if (!_lambdas.empty()) {
+    json.chop(2);  // Remove the last ", ".
+  }
+  json += "], \"swaps\" : [";
+  for (unsigned int k = 0; k < _swapAttempts.size(); ++k) {
+    const double rate = (_swapAttempts[k] > 0)
+        ? static_cast<double>(_swapAccepts[k]) / _swapAttempts[k] : 0.0;
+    json += "{\"lambdas\" : [" + QString::number(_lambdas[k]) + ", " +
+            QString::number(_lambdas[k + 1]) + "], ";
+    json += "\"attempts\" : " + QString::number(_swapAttempts[k]) + ", ";
+    json += "\"accepted\" : " + QString::number(_swapAccepts[k]) + ", ";
+    json += "\"rate\" : " + QString::number(rate) + "}, ";
+  }
+  if (!_swapAttempts.empty()) {
+    json.chop(2);  // Remove the last ", ".
+  }
+  json += "]}";
+  return json;
+}
+
+bool CompressionTempering::exportMetrics(const QString filePath) const {
+  QFile outFile(filePath);
+  if (!outFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    return false;
+  }
+  QTextStream outStream(&outFile);
+  outStream << metricsAsJSON();
+  outFile.close();
+
+  return true;
+}
+
+void CompressionTempering::attemptSwaps(const int first) {
+  for (unsigned int k = first; k + 1 < _lambdas.size(); k += 2) {
+    const int p = _perimeterHistories[k].back();
+    const int pNext = _perimeterHistories[k + 1].back();
+    const double acceptProb =
+        std::pow(_lambdas[k] / _lambdas[k + 1], p - pNext);
+
+    ++_swapAttempts[k];
+    if (_rng.randDouble(0, 1) < acceptProb) {
+      ++_swapAccepts[k];
+      std::swap(_replicaAt[k], _replicaAt[k + 1]);
+      _replicas[_replicaAt[k]]->setLambda(_lambdas[k]);
+      _replicas[_replicaAt[k + 1]]->setLambda(_lambdas[k + 1]);
+    }
+  }
+}
@@ -0,0 +1,84 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines parallel tempering (replica exchange) for the Compression Algorithm.
+// Near the compression/expansion transition, a single chain at a fixed bias
+// mixes slowly. Instead, K replicas at increasing biases lambda_0 < ... <
+// lambda_{K-1} run concurrently (one per thread) for a fixed number of rounds
+// per epoch, after which the configurations of neighboring biases are swapped
+// with the Metropolis probability
+//
+//   min(1, (lambda_k / lambda_{k+1})^(p_k - p_{k+1})),
+//
+// where p_k is the perimeter of the configuration at lambda_k. This preserves
+// each bias's stationary distribution, which is proportional to
+// lambda^(-perimeter), while letting configurations escape local traps at
+// lower biases. Epochs alternate between swapping the pairs starting at even
+// and at odd k. Swapping two configurations is done by swapping the biases of
+// the replicas holding them. The perimeter counts a particle that is expanded
+// mid-move at its tail, i.e., at the position the chain's current state has.
+//
+// Replicas are BitboardCompressionSystems (see alg/compressionbitboard.h),
+// replica k seeded with baseSeed + k. Since every replica runs a fixed number
+// of rounds per epoch and swaps are decided on the calling thread, results do
+// not depend on the number of threads.
+
+#ifndef AMOEBOTSIM_ALG_COMPRESSIONTEMPERING_H_
+#define AMOEBOTSIM_ALG_COMPRESSIONTEMPERING_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <QString>
+
+#include "alg/compressionbitboard.h"
+#include "helper/randomnumbergenerator.h"
+
+class CompressionTempering {
+ public:
+  // Constructs one replica of the given size per given bias (each > 1, sorted
+  // in increasing order), attempting swaps every roundsPerEpoch rounds.
+  CompressionTempering(const int numParticles, std::vector<double> lambdas,
+                       const uint64_t baseSeed, const int roundsPerEpoch = 10);
+
+  // Runs every replica until it has completed the given number of rounds, on
+  // the given number of worker threads (one per hardware thread if
+  // numThreads <= 0), blocking until done.
+  void run(const int numRounds, int numThreads = 0);
+
+  // Formats the perimeter history of every bias and the swap acceptance rate
+  // of every pair of neighboring biases as a JSON string. See the Usage
+  // documentation for its structure.
+  const QString metricsAsJSON() const;
+
+  // Writes metricsAsJSON to the given file, returning false if it can't be
+  // opened.
+  bool exportMetrics(const QString filePath) const;
+
+ private:
+  // Attempts to swap the configurations of every other pair of neighboring
+  // biases, starting with the given bias index (0 or 1).
+  void attemptSwaps(const int first);
+
+  const std::vector<double> _lambdas;
+  const uint64_t _baseSeed;
+  const int _roundsPerEpoch;
+  std::vector<std::unique_ptr<BitboardCompressionSystem>> _replicas;
+
+  // _replicaAt[k] is the index of the replica currently at bias k.
+  std::vector<int> _replicaAt;
+
+  // The perimeter at every bias at the end of every epoch, and the number of
+  // attempted and accepted swaps between biases k and k + 1.
+  std::vector<std::vector<int>> _perimeterHistories;
+  std::vector<int> _swapAttempts;
+  std::vector<int> _swapAccepts;
+  int _numEpochs;
+
+  // Decides swaps; seeded independently of the replicas.
+  RandomNumberGenerator _rng;
+};
+
+#endif  // AMOEBOTSIM_ALG_COMPRESSIONTEMPERING_H_
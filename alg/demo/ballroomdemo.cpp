@@ -4,6 +4,8 @@
 
 #include "alg/demo/ballroomdemo.h"
 
+#include <cmath>
+
 BallroomDemoParticle::BallroomDemoParticle(const Node head,
                                            const int globalTailDir,
                                            const int orientation,
@@ -154,14 +156,16 @@ BallroomDemoSystem::BallroomDemoSystem(unsigned int numParticles) {
     if (occupied.find(leaderNode) == occupied.end()
         && occupied.find(followerNode) == occupied.end()) {
       BallroomDemoParticle* leader =
-          new BallroomDemoParticle(leaderNode, -1, randDir(), *this,
-                                   BallroomDemoParticle::State::Leader);
+          newParticle<BallroomDemoParticle>(
+              leaderNode, -1, randDir(), *this,
+              BallroomDemoParticle::State::Leader);
       insert(leader);
       occupied.insert(leaderNode);
 
       BallroomDemoParticle* follower =
-          new BallroomDemoParticle(followerNode, -1, randDir(), *this,
-                                   BallroomDemoParticle::State::Follower);
+          newParticle<BallroomDemoParticle>(
+              followerNode, -1, randDir(), *this,
+              BallroomDemoParticle::State::Follower);
       follower->_partnerLbl = follower->globalToLocalDir((followerDir + 3) % 6);
       insert(follower);
       occupied.insert(followerNode);
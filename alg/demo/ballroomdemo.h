@@ -15,6 +15,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class BallroomDemoParticle : public AmoebotParticle {
  public:
@@ -75,7 +76,7 @@ class BallroomDemoParticle : public AmoebotParticle {
   friend class BallroomDemoSystem;
 };
 
-class BallroomDemoSystem : public AmoebotSystem {
+class BallroomDemoSystem : public TypedAmoebotSystem<BallroomDemoParticle> {
  public:
   // Constructs a system of the specified number of BallroomDemoParticles in
   // "dance partner" pairs enclosed by a rhombic ring of objects.
@@ -4,6 +4,8 @@
 
 #include "alg/demo/discodemo.h"
 
+#include <cmath>
+
 DiscoDemoParticle::DiscoDemoParticle(const Node& head, const int globalTailDir,
                                      const int orientation,
                                      AmoebotSystem& system,
@@ -112,7 +114,8 @@ DiscoDemoSystem::DiscoDemoSystem(unsigned int numParticles, int counterMax) {
     // If the node satisfies (iii) and is unoccupied, place a particle there.
     if (0 < x + y && x + y < 2 * sideLen
         && occupied.find(node) == occupied.end()) {
-      insert(new DiscoDemoParticle(node, -1, randDir(), *this, counterMax));
+      insert(newParticle<DiscoDemoParticle>(node, -1, randDir(), *this,
+                                            counterMax));
       occupied.insert(node);
     }
   }
@@ -16,6 +16,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class DiscoDemoParticle : public AmoebotParticle {
  public:
@@ -64,7 +65,7 @@ class DiscoDemoParticle : public AmoebotParticle {
   friend class DiscoDemoSystem;
 };
 
-class DiscoDemoSystem : public AmoebotSystem {
+class DiscoDemoSystem : public TypedAmoebotSystem<DiscoDemoParticle> {
  public:
   // Constructs a system of the specified number of DiscoDemoParticles enclosed
   // by a hexagonal ring of objects.
@@ -12,6 +12,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class DynamicDemoParticle : public AmoebotParticle {
  public:
@@ -39,7 +40,7 @@ class DynamicDemoParticle : public AmoebotParticle {
   friend class DynamicDemoSystem;
 };
 
-class DynamicDemoSystem : public AmoebotSystem {
+class DynamicDemoSystem : public TypedAmoebotSystem<DynamicDemoParticle> {
  public:
   // Constructs a system of DynamicDemoParticles with an optionally specified
   // size (#particles) and particle growth and death probabilities.
@@ -11,11 +11,16 @@ MetricsDemoParticle::MetricsDemoParticle(const Node& head,
                                          const int globalTailDir,
                                          const int orientation,
                                          AmoebotSystem& system,
-                                         const int counterMax)
+                                         const int counterMax,
+                                         Count& wallBumps,
+                                         PercentRedMeasure& percentRed)
     : AmoebotParticle(head, globalTailDir, orientation, system),
       _counter(counterMax),
-      _counterMax(counterMax) {
+      _counterMax(counterMax),
+      _wallBumps(wallBumps),
+      _percentRed(percentRed) {
   _state = getRandColor();
+  _percentRed.record({_state == State::Red});
 }
 
 void MetricsDemoParticle::activate() {
@@ -24,7 +29,7 @@ void MetricsDemoParticle::activate() {
   _counter--;
   if (_counter == 0) {
     _counter = _counterMax;
-    _state = getRandColor();
+    setState(getRandColor());
   }
 
   // Next, handle movement. If the particle is contracted, choose a random
@@ -36,7 +41,7 @@ void MetricsDemoParticle::activate() {
     if (canExpand(expandDir)) {
       expand(expandDir);
     } else if (hasObjectAtLabel(expandDir)) {
-      system.getCount("# Wall Bumps").record();
+      _wallBumps.record();
     }
   } else {  // isExpanded().
     contractTail();
@@ -92,7 +97,18 @@ MetricsDemoParticle::State MetricsDemoParticle::getRandColor() const {
   return static_cast<State>(randInt(0, 7));
 }
 
+void MetricsDemoParticle::setState(const State state) {
+  _percentRed.record({(state == State::Red) - (_state == State::Red)});
+  _state = state;
+}
+
 MetricsDemoSystem::MetricsDemoSystem(unsigned int numParticles, int counterMax) {
+  // Set up the wall bumps count and the red percentage measure first, as the
+  // particles record to them directly.
+  Count& wallBumps = addCount("# Wall Bumps");
+  PercentRedMeasure* percentRed = new PercentRedMeasure("% Red", 1, *this);
+  _measures.push_back(percentRed);
+
   // In order to enclose an area that's roughly 3.7x the # of particles using a
   // regular hexagon, the hexagon should have side length 1.4*sqrt(# particles).
   int sideLen = static_cast<int>(std::round(1.4 * std::sqrt(numParticles)));
@@ -118,36 +134,25 @@ MetricsDemoSystem::MetricsDemoSystem(unsigned int numParticles, int counterMax)
     // If the node satisfies (iii) and is unoccupied, place a particle there.
     if (0 < x + y && x + y < 2 * sideLen
         && occupied.find(node) == occupied.end()) {
-      insert(new MetricsDemoParticle(node, -1, randDir(), *this, counterMax));
+      insert(newParticle<MetricsDemoParticle>(node, -1, randDir(), *this,
+                                              counterMax, wallBumps,
+                                              *percentRed));
       occupied.insert(node);
     }
   }
 
-  // Set up metrics.
-  _counts.push_back(new Count("# Wall Bumps"));
-  _measures.push_back(new PercentRedMeasure("% Red", 1, *this));
+  // Set up the remaining measures.
   _measures.push_back(new MaxDistanceMeasure("Max. Distance", 1, *this));
 }
 
 PercentRedMeasure::PercentRedMeasure(const QString name,
                                      const unsigned int freq,
                                      MetricsDemoSystem& system)
-    : Measure(name, freq),
+    : IncrementalMeasure(name, freq),
       _system(system) {}
 
-double PercentRedMeasure::calculate() const {
-  int numRed = 0;
-
-  // Loop through all particles of the system.
-  for (const auto& p : _system.particles) {
-    // Convert the pointer to a MetricsDemoParticle so its color can be checked.
-    auto metr_p = dynamic_cast<MetricsDemoParticle*>(p);
-    if (metr_p->_state == MetricsDemoParticle::State::Red) {
-      numRed++;
-    }
-  }
-
-  return numRed / static_cast<double>(_system.size()) * 100;
+double PercentRedMeasure::value(const Sums& sums) const {
+  return sums[0] / static_cast<double>(_system.size()) * 100;
 }
 
 MaxDistanceMeasure::MaxDistanceMeasure(const QString name,
@@ -15,10 +15,11 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
-class MetricsDemoParticle : public AmoebotParticle {
-  friend class PercentRedMeasure;
+class PercentRedMeasure;
 
+class MetricsDemoParticle : public AmoebotParticle {
  public:
   enum class State {
     Red,
@@ -32,11 +33,13 @@ class MetricsDemoParticle : public AmoebotParticle {
 
   // Constructs a new particle with a node position for its head, a global
   // compass direction from its head to its tail (-1 if contracted), an offset
-  // for its local compass, a system that it belongs to, and a maximum value for
-  // its counter.
+  // for its local compass, a system that it belongs to, a maximum value for its
+  // counter, and the system's wall bumps count and red percentage measure to
+  // record to.
   MetricsDemoParticle(const Node& head, const int globalTailDir,
                       const int orientation, AmoebotSystem& system,
-                      const int counterMax);
+                      const int counterMax, Count& wallBumps,
+                      PercentRedMeasure& percentRed);
 
   // Executes one particle activation.
   void activate() override;
@@ -56,17 +59,22 @@ class MetricsDemoParticle : public AmoebotParticle {
   // Returns a random State.
   State getRandColor() const;
 
+  // Changes the particle's state, recording whether it became or stopped being
+  // red.
+  void setState(const State state);
+
   // Member variables.
   State _state;
   int _counter;
   const int _counterMax;
+  Count& _wallBumps;
+  PercentRedMeasure& _percentRed;
 
  private:
   friend class MetricsDemoSystem;
 };
 
-class MetricsDemoSystem : public AmoebotSystem {
-  friend class PercentRedMeasure;
+class MetricsDemoSystem : public TypedAmoebotSystem<MetricsDemoParticle> {
   friend class MaxDistanceMeasure;
 
  public:
@@ -75,17 +83,18 @@ class MetricsDemoSystem : public AmoebotSystem {
   MetricsDemoSystem(unsigned int numParticles = 30, int counterMax = 5);
 };
 
-class PercentRedMeasure : public Measure {
+class PercentRedMeasure : public IncrementalMeasure<1> {
  public:
   // Constructs a PercentRedMeasure by using the parent constructor and adding a
-  // reference to the MetricsDemoSystem being measured.
+  // reference to the MetricsDemoSystem being measured. Its only sum is the
+  // number of red particles, which the particles record as they change color.
   PercentRedMeasure(const QString name, const unsigned int freq,
                     MetricsDemoSystem& system);
 
-  // Calculated the percentage of particles in the system in the Red state.
-  double calculate() const final;
-
  protected:
+  // Calculates the percentage of particles in the system in the Red state.
+  double value(const Sums& sums) const final;
+
   MetricsDemoSystem& _system;
 };
 
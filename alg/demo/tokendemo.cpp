@@ -4,6 +4,8 @@
 
 #include "alg/demo/tokendemo.h"
 
+#include <cmath>
+
 TokenDemoParticle::TokenDemoParticle(const Node& head, const int globalTailDir,
                                      const int orientation,
                                      AmoebotSystem& system)
@@ -94,18 +96,19 @@ TokenDemoSystem::TokenDemoSystem(int numParticles, int lifetime) {
     for (int i = 0; i < sideLen; ++i) {
       // Give the first particle five tokens of each color.
       if (hexNode.x == 0 && hexNode.y == 0) {
-        auto firstP = new TokenDemoParticle(Node(0, 0), -1, randDir(), *this);
+        auto firstP = newParticle<TokenDemoParticle>(Node(0, 0), -1, randDir(),
+                                                     *this);
         for (int j = 0; j < 5; ++j) {
-          auto redToken = std::make_shared<TokenDemoParticle::RedToken>();
+          auto redToken = makeToken<TokenDemoParticle::RedToken>();
           redToken->_lifetime = lifetime;
           firstP->putToken(redToken);
-          auto blueToken = std::make_shared<TokenDemoParticle::BlueToken>();
+          auto blueToken = makeToken<TokenDemoParticle::BlueToken>();
           blueToken->_lifetime = lifetime;
           firstP->putToken(blueToken);
         }
         insert(firstP);
       } else {
-        insert(new TokenDemoParticle(hexNode, -1, randDir(), *this));
+        insert(newParticle<TokenDemoParticle>(hexNode, -1, randDir(), *this));
       }
 
       hexNode = hexNode.nodeInDir(dir);
@@ -114,8 +117,7 @@ TokenDemoSystem::TokenDemoSystem(int numParticles, int lifetime) {
 }
 
 bool TokenDemoSystem::hasTerminated() const {
-  for (auto p : particles) {
-    auto tdp = dynamic_cast<TokenDemoParticle*>(p);
+  for (auto tdp : typedParticles()) {
     if (tdp->hasToken<TokenDemoParticle::DemoToken>()) {
       return false;
     }
@@ -13,6 +13,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class TokenDemoParticle : public AmoebotParticle {
  public:
@@ -52,7 +53,7 @@ class TokenDemoParticle : public AmoebotParticle {
   friend class TokenDemoSystem;
 };
 
-class TokenDemoSystem : public AmoebotSystem {
+class TokenDemoSystem : public TypedAmoebotSystem<TokenDemoParticle> {
  public:
   // Constructs a system of TokenDemoParticles with an optionally specified size
   // (#particles) and token lifetime.
@@ -4,6 +4,8 @@
 
 #include "alg/edfhexagonformation.h"
 
+#include <cmath>
+
 EDFHexagonFormationParticle::EDFHexagonFormationParticle(
     const Node head,
     AmoebotSystem& system,
@@ -11,14 +13,14 @@ EDFHexagonFormationParticle::EDFHexagonFormationParticle(
     const int transferRate,
     const int demand,
     const ShapeState sState)
-    : AmoebotParticle(head, -1, randDir(), system),
+    : AmoebotParticle(head, -1, system.randDir(), system),
       _capacity(capacity),
       _transferRate(transferRate),
       _demand(demand),
-      _eState(EnergyState::Idle),
+      _eState(system.stateCounter<EnergyState>(), EnergyState::Idle),
       _eParentLabel(-1),
       _battery(0),
-      _sState(sState),
+      _sState(system.stateCounter<ShapeState>(), sState),
       _sParentDir(-1),
       _hexagonDir(sState == ShapeState::Seed ? 0 : -1) {}
 
@@ -87,7 +89,7 @@ void EDFHexagonFormationParticle::activate() {
 
       // Choose any contracted tail child to pull in a handover.
       int childLabel = conTailChildLabels()[0];
-      auto child = nbrAtLabel(childLabel);
+      auto& child = nbrAtLabel(childLabel);
 
       // Pulling this child will make it expand, so we need to update its energy
       // parent pointer and hexagon parent pointers before pulling.
@@ -402,7 +404,7 @@ EDFHexagonFormationSystem::EDFHexagonFormationSystem(int numParticles,
                                                      int demand) {
   // Insert the shape formation seed at (0,0).
   std::set<Node> occupied;
-  insert(new EDFHexagonFormationParticle(
+  insert(newParticle<EDFHexagonFormationParticle>(
       Node(0, 0), *this, capacity, transferRate, demand,
       EDFHexagonFormationParticle::ShapeState::Seed));
   occupied.insert(Node(0, 0));
@@ -431,7 +433,7 @@ EDFHexagonFormationSystem::EDFHexagonFormationSystem(int numParticles,
 
     // With probability 1 - holeProb, add a new particle at the candidate node.
     if (randBool(1.0 - holeProb)) {
-      insert(new EDFHexagonFormationParticle(
+      insert(newParticle<EDFHexagonFormationParticle>(
           randCand, *this, capacity, transferRate, demand,
           EDFHexagonFormationParticle::ShapeState::Idle));
       occupied.insert(randCand);
@@ -457,26 +459,31 @@ EDFHexagonFormationSystem::EDFHexagonFormationSystem(int numParticles,
   }
   shuffle(indices.begin(), indices.end());
   for (int i = 0; i < numEnergySources; ++i) {
-    auto ehp = dynamic_cast<EDFHexagonFormationParticle*>(particles[indices[i]]);
+    auto ehp = particleAt(indices[i]);
     ehp->_eState = EDFHexagonFormationParticle::EnergyState::Source;
   }
 }
 
 bool EDFHexagonFormationSystem::hasTerminated() const {
-  // Check if all amoebots are in the spanning forest and have full batteries.
-  for (auto p : particles) {
-    auto ehp = dynamic_cast<EDFHexagonFormationParticle*>(p);
-    if (ehp->_eState == EDFHexagonFormationParticle::EnergyState::Idle
-        || ehp->_eState == EDFHexagonFormationParticle::EnergyState::Pruning
-        || ehp->_battery < ehp->_capacity)
-      return false;
+  using EnergyState = EDFHexagonFormationParticle::EnergyState;
+  using ShapeState = EDFHexagonFormationParticle::ShapeState;
+
+  // Check that all particles are in the spanning forest.
+  const auto& eStates = stateCounter<EnergyState>();
+  if (eStates.count({EnergyState::Idle, EnergyState::Pruning}) > 0) {
+    return false;
   }
 
   // Check that all particles are either the seed or retired.
-  for (auto p : particles) {
-    auto ehp = dynamic_cast<EDFHexagonFormationParticle*>(p);
-    if (ehp->_sState != EDFHexagonFormationParticle::ShapeState::Seed
-        && ehp->_sState != EDFHexagonFormationParticle::ShapeState::Retired)
+  const auto& sStates = stateCounter<ShapeState>();
+  if (sStates.count({ShapeState::Seed, ShapeState::Retired})
+      != sStates.total()) {
+    return false;
+  }
+
+  // Only then check that all particles have full batteries.
+  for (auto ehp : typedParticles()) {
+    if (ehp->_battery < ehp->_capacity)
       return false;
   }
 
@@ -14,6 +14,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class EDFHexagonFormationParticle : public AmoebotParticle {
  public:
@@ -120,12 +121,12 @@ class EDFHexagonFormationParticle : public AmoebotParticle {
   const int _demand;
 
   // Energy distribution framework variables.
-  EnergyState _eState;
+  CountedState<EnergyState> _eState;
   int _eParentLabel;
   double _battery;
 
   // Hexagon-Formation variables.
-  ShapeState _sState;
+  CountedState<ShapeState> _sState;
   int _sParentDir;
   int _hexagonDir;
 
@@ -133,7 +134,8 @@ class EDFHexagonFormationParticle : public AmoebotParticle {
   friend class EDFHexagonFormationSystem;
 };
 
-class EDFHexagonFormationSystem : public AmoebotSystem {
+class EDFHexagonFormationSystem
+    : public TypedAmoebotSystem<EDFHexagonFormationParticle> {
  public:
   // Constructs a system of EDFHexagonFormationParticles with an optionally
   // specified size (#particles), number of energy source particles, hole
@@ -4,20 +4,22 @@
 
 #include "alg/edfleaderelectionbyerosion.h"
 
+#include <cmath>
+
 EDFLeaderElectionByErosionParticle::EDFLeaderElectionByErosionParticle(
     const Node head,
     AmoebotSystem& system,
     const int capacity,
     const int transferRate,
     const int demand)
-    : AmoebotParticle(head, -1, randDir(), system),
+    : AmoebotParticle(head, -1, system.randDir(), system),
       _capacity(capacity),
       _transferRate(transferRate),
       _demand(demand),
-      _eState(EnergyState::Idle),
+      _eState(system.stateCounter<EnergyState>(), EnergyState::Idle),
       _eParentDir(-1),
       _battery(0),
-      _lState(LeaderState::Null) {}
+      _lState(system.stateCounter<LeaderState>(), LeaderState::Null) {}
 
 void EDFLeaderElectionByErosionParticle::activate() {
   // Prioritize Leader-Election-By-Erosion actions over energy distribution.
@@ -355,8 +357,8 @@ EDFLeaderElectionByErosionSystem::EDFLeaderElectionByErosionSystem(
       }
     }
 
-    insert(new EDFLeaderElectionByErosionParticle(Node(x, y), *this, capacity,
-                                                  transferRate, demand));
+    insert(newParticle<EDFLeaderElectionByErosionParticle>(
+        Node(x, y), *this, capacity, transferRate, demand));
   }
 
   // Choose source particles uniformly at random.
@@ -366,28 +368,31 @@ EDFLeaderElectionByErosionSystem::EDFLeaderElectionByErosionSystem(
   }
   shuffle(indices.begin(), indices.end());
   for (int i = 0; i < numEnergySources; ++i) {
-    auto elp = dynamic_cast<EDFLeaderElectionByErosionParticle*>(
-        particles[indices[i]]);
+    auto elp = particleAt(indices[i]);
     elp->_eState = EDFLeaderElectionByErosionParticle::EnergyState::Source;
   }
 }
 
 bool EDFLeaderElectionByErosionSystem::hasTerminated() const {
-  // Check if all amoebots are in the spanning forest and have full batteries.
-  for (auto p : particles) {
-    auto elp = dynamic_cast<EDFLeaderElectionByErosionParticle*>(p);
-    if (elp->_eState == EDFLeaderElectionByErosionParticle::EnergyState::Idle
-        || elp->_eState == EDFLeaderElectionByErosionParticle::EnergyState::Pruning
-        || elp->_battery < elp->_capacity)
-      return false;
+  using EnergyState = EDFLeaderElectionByErosionParticle::EnergyState;
+  using LeaderState = EDFLeaderElectionByErosionParticle::LeaderState;
+
+  // Check that all particles are in the spanning forest.
+  const auto& eStates = stateCounter<EnergyState>();
+  if (eStates.count({EnergyState::Idle, EnergyState::Pruning}) > 0) {
+    return false;
   }
 
   // Check that a leader has emerged.
-  for (auto p : particles) {
-    auto elp = dynamic_cast<EDFLeaderElectionByErosionParticle*>(p);
-    if (elp->_lState == EDFLeaderElectionByErosionParticle::LeaderState::Leader)
-      return true;
+  if (stateCounter<LeaderState>().count(LeaderState::Leader) == 0) {
+    return false;
   }
 
-  return false;
+  // Only then check that all particles have full batteries.
+  for (auto elp : typedParticles()) {
+    if (elp->_battery < elp->_capacity)
+      return false;
+  }
+
+  return true;
 }
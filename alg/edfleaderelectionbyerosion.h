@@ -12,6 +12,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class EDFLeaderElectionByErosionParticle : public AmoebotParticle {
  public:
@@ -100,18 +101,19 @@ class EDFLeaderElectionByErosionParticle : public AmoebotParticle {
   const int _demand;
 
   // Energy distribution framework variables.
-  EnergyState _eState;
+  CountedState<EnergyState> _eState;
   int _eParentDir;
   double _battery;
 
   // Leader-Election-By-Erosion variables.
-  LeaderState _lState;
+  CountedState<LeaderState> _lState;
 
  private:
   friend class EDFLeaderElectionByErosionSystem;
 };
 
-class EDFLeaderElectionByErosionSystem : public AmoebotSystem {
+class EDFLeaderElectionByErosionSystem
+    : public TypedAmoebotSystem<EDFLeaderElectionByErosionParticle> {
   public:
   // Constructs a system of EDFLeaderElectionByErosionParticles with an
   // optionally specified size (#particles) in the shape of a hexagon, since
@@ -5,6 +5,7 @@
 #include "alg/energyshape.h"
 
 #include <algorithm>
+#include <cmath>
 #include <set>
 
 EnergyShapeParticle::EnergyShapeParticle(const Node& head, int globalTailDir,
@@ -14,11 +15,13 @@ EnergyShapeParticle::EnergyShapeParticle(const Node& head, int globalTailDir,
                                          const double demand,
                                          const double transferRate,
                                          const EnergyState eState,
-                                         const ShapeState sState)
+                                         const ShapeState sState,
+                                         Count& actionCount)
     : AmoebotParticle(head, globalTailDir, orientation, system),
       _capacity(capacity),
       _demand(demand),
       _transferRate(transferRate),
+      _actionCount(actionCount),
       _battery(0),
       _stress(false),
       _inhibit(false),
@@ -26,7 +29,7 @@ EnergyShapeParticle::EnergyShapeParticle(const Node& head, int globalTailDir,
       _eState(eState),
       _parentLabel(-1),
       _lastParent(0),
-      _sState(sState),
+      _sState(system.stateCounter<ShapeState>(), sState),
       _constructionDir(-1),
       _moveDir(-1),
       _followDir(-1) {
@@ -195,7 +198,7 @@ void EnergyShapeParticle::shareEnergy() {
     // If there is a child with a non-full battery, share with one at random.
     if (!needyChildLabels.empty()) {
       int childLabel = needyChildLabels[randInt(0, needyChildLabels.size())];
-      auto child = nbrAtLabel(childLabel);
+      auto& child = nbrAtLabel(childLabel);
       _battery -= std::min(_transferRate, _capacity - child._battery);
       nbrAtLabel(childLabel)._battery = std::min(child._battery + _transferRate,
                                                  _capacity);
@@ -243,7 +246,7 @@ void EnergyShapeParticle::useEnergy() {
           updateMoveDir();
           didAction = true;
         } else if (hasTailAtLabel(_followDir)) {
-          auto nbr = nbrAtLabel(_followDir);
+          auto& nbr = nbrAtLabel(_followDir);
           int nbrContractDir = nbrDirToDir(nbr, (nbr.tailDir() + 3) % 6);
           nbrAtLabel(_followDir).prune();  // DO NOT USE nbr.prune()!
           nbrAtLabel(_followDir)._lastParent = nbr.labelToDir(nbr._lastParent);
@@ -265,7 +268,7 @@ void EnergyShapeParticle::useEnergy() {
             _lastParent = labelToDirAfterExpansion(_lastParent, _moveDir);
             expand(_moveDir);
           } else if (hasTailAtLabel(_moveDir)) {
-            auto nbr = nbrAtLabel(_moveDir);
+            auto& nbr = nbrAtLabel(_moveDir);
             nbrAtLabel(_moveDir).prune();  // DO NOT USE nbr.prune()!
             nbrAtLabel(_moveDir)._lastParent = nbr.labelToDir(nbr._lastParent);
             prune();
@@ -279,7 +282,7 @@ void EnergyShapeParticle::useEnergy() {
 
     if (didAction) {
       _battery -= _demand;
-      system.getCount("# Actions").record();
+      _actionCount.record();
     }
   }
 }
@@ -375,14 +378,14 @@ EnergyShapeSystem::EnergyShapeSystem(const int numParticles,
                                      const double capacity,
                                      const double demand,
                                      const double transferRate) {
-  _counts.push_back(new Count("# Actions"));
+  Count& actionCount = addCount("# Actions");
 
   // Insert the energy distribution root/shape formation seed at (0,0).
   std::set<Node> occupied;
-  insert(new EnergyShapeParticle(Node(0, 0), -1, randDir(), *this, capacity,
-                                 demand, transferRate,
-                                 EnergyShapeParticle::EnergyState::Idle,
-                                 EnergyShapeParticle::ShapeState::Seed));
+  insert(newParticle<EnergyShapeParticle>(
+      Node(0, 0), -1, randDir(), *this, capacity, demand, transferRate,
+      EnergyShapeParticle::EnergyState::Idle,
+      EnergyShapeParticle::ShapeState::Seed, actionCount));
   occupied.insert(Node(0, 0));
 
   std::set<Node> candidates;
@@ -408,10 +411,10 @@ EnergyShapeSystem::EnergyShapeSystem(const int numParticles,
 
     // With probability 1 - holeProb, add a new particle at the candidate node.
     if (randBool(1.0 - holeProb)) {
-      insert(new EnergyShapeParticle(randCand, -1, randDir(), *this, capacity,
-                                     demand, transferRate,
-                                     EnergyShapeParticle::EnergyState::Idle,
-                                     EnergyShapeParticle::ShapeState::Idle));
+      insert(newParticle<EnergyShapeParticle>(
+          randCand, -1, randDir(), *this, capacity, demand, transferRate,
+          EnergyShapeParticle::EnergyState::Idle,
+          EnergyShapeParticle::ShapeState::Idle, actionCount));
       occupied.insert(randCand);
       particlesAdded++;
 
@@ -435,14 +438,21 @@ EnergyShapeSystem::EnergyShapeSystem(const int numParticles,
   }
   shuffle(indices.begin(), indices.end());
   for (int i = 0; i < numEnergyRoots; ++i) {
-    auto esp = dynamic_cast<EnergyShapeParticle*>(particles[indices[i]]);
+    auto esp = particleAt(indices[i]);
     esp->_eState = EnergyShapeParticle::EnergyState::Root;
   }
 }
 
 bool EnergyShapeSystem::hasTerminated() const {
-  for (auto p : particles) {
-    auto esp = dynamic_cast<EnergyShapeParticle*>(p);
+  // Only scan for stressed or inhibited particles once the shape state counter
+  // shows that every particle has finished.
+  using ShapeState = EnergyShapeParticle::ShapeState;
+  const auto& sStates = stateCounter<ShapeState>();
+  if (sStates.count({ShapeState::Seed, ShapeState::Finish}) != sStates.total()) {
+    return false;
+  }
+
+  for (auto esp : typedParticles()) {
     if (esp->_stress || esp->_inhibit ||
         (esp->_sState != EnergyShapeParticle::ShapeState::Seed
          && esp->_sState != EnergyShapeParticle::ShapeState::Finish)) {
@@ -11,6 +11,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class EnergyShapeParticle : public AmoebotParticle {
  public:
@@ -32,12 +33,12 @@ class EnergyShapeParticle : public AmoebotParticle {
   // compass direction from its head to its tail (-1 if contracted), an offset
   // for its local compass, a system which it belongs to, a capacity for its
   // battery, an energy demand for its actions, an energy transfer rate, an
-  // energy state, and a shape state.
+  // energy state, a shape state, and the system's action count to record to.
   EnergyShapeParticle(const Node& head, int globalTailDir,
                       const int orientation, AmoebotSystem& system,
                       const double capacity, const double demand,
                       const double transferRate, const EnergyState eState,
-                      const ShapeState sState);
+                      const ShapeState sState, Count& actionCount);
 
   // Executes one particle activation.
   void activate() override;
@@ -115,6 +116,7 @@ class EnergyShapeParticle : public AmoebotParticle {
   const double _capacity;
   const double _demand;
   const double _transferRate;
+  Count& _actionCount;
 
   // Energy Distribution variables.
   double _battery;
@@ -126,7 +128,7 @@ class EnergyShapeParticle : public AmoebotParticle {
   int _lastParent;
 
   // Shape Formation variables.
-  ShapeState _sState;
+  CountedState<ShapeState> _sState;
   int _constructionDir;
   int _moveDir;
   int _followDir;
@@ -135,7 +137,7 @@ class EnergyShapeParticle : public AmoebotParticle {
   friend class EnergyShapeSystem;
 };
 
-class EnergyShapeSystem : public AmoebotSystem {
+class EnergyShapeSystem : public TypedAmoebotSystem<EnergyShapeParticle> {
  public:
   // Constructs a system of EnergyShapeParticles with an optionally specified
   // size (# particles), number of energy distribution root particles, hole
@@ -5,6 +5,7 @@
 #include "alg/energysharing.h"
 
 #include <algorithm>  // for std::min, std::max.
+#include <cmath>
 
 EnergySharingParticle::EnergySharingParticle(const Node& head,
                                              int globalTailDir,
@@ -14,12 +15,14 @@ EnergySharingParticle::EnergySharingParticle(const Node& head,
                                              const double demand,
                                              const double transferRate,
                                              const Usage usage,
-                                             const State state)
+                                             const State state,
+                                             Count& actionCount)
     : AmoebotParticle (head, globalTailDir, orientation, system),
       _capacity(capacity),
       _demand(demand),
       _transferRate(transferRate),
       _usage(usage),
+      _actionCount(actionCount),
       _battery(0),
       _stress(false),
       _inhibit(false),
@@ -154,7 +157,7 @@ void EnergySharingParticle::useEnergy() {
   if (!_inhibit && _battery >= _demand) {
     if (_usage == Usage::Uniform) {
       _battery -= _demand;
-      system.getCount("# Actions").record();
+      _actionCount.record();
     } else if (_usage == Usage::Reproduce) {
       int reproduceDir = -1;
       for (int dir = 0; dir < 6; dir++) {
@@ -166,11 +169,11 @@ void EnergySharingParticle::useEnergy() {
 
       if (reproduceDir != -1) {
         _battery -= _demand;
-        system.getCount("# Actions").record();
-        system.insert(new EnergySharingParticle(
-                        head.nodeInDir(localToGlobalDir(reproduceDir)), -1,
-                        randDir(), system, _capacity, _demand, _transferRate,
-                        _usage, State::Idle));
+        _actionCount.record();
+        system.insert(system.newParticle<EnergySharingParticle>(
+            head.nodeInDir(localToGlobalDir(reproduceDir)), -1, randDir(),
+            system, _capacity, _demand, _transferRate, _usage, State::Idle,
+            _actionCount));
       }
     } else {
       Q_ASSERT(false);  // An invalid usage type was used.
@@ -204,7 +207,7 @@ EnergySharingSystem::EnergySharingSystem(int numParticles,
                                          const double capacity,
                                          const double demand,
                                          const double transferRate) {
-  _counts.push_back(new Count("# Actions"));
+  Count& actionCount = addCount("# Actions");
 
   // Add a hexagon of idle particles to the system.
   int x, y;
@@ -250,10 +253,10 @@ EnergySharingSystem::EnergySharingSystem(int numParticles,
       }
     }
 
-    insert(new EnergySharingParticle(Node(x, y), -1, randDir(), *this,
-                                     capacity, demand, transferRate,
-                                     static_cast<EnergySharingParticle::Usage>(usage),
-                                     EnergySharingParticle::State::Idle));
+    insert(newParticle<EnergySharingParticle>(
+        Node(x, y), -1, randDir(), *this, capacity, demand, transferRate,
+        static_cast<EnergySharingParticle::Usage>(usage),
+        EnergySharingParticle::State::Idle, actionCount));
   }
 
   // Choose particles at random to make energy ditribution roots.
@@ -263,7 +266,7 @@ EnergySharingSystem::EnergySharingSystem(int numParticles,
   }
   shuffle(indices.begin(), indices.end());
   for (int i = 0; i < numEnergyRoots; ++i) {
-    auto ep = dynamic_cast<EnergySharingParticle*>(particles[indices[i]]);
+    auto ep = particleAt(indices[i]);
     ep->_state = EnergySharingParticle::State::Root;
   }
 }
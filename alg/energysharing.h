@@ -11,6 +11,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class EnergySharingParticle : public AmoebotParticle {
  public:
@@ -29,12 +30,12 @@ class EnergySharingParticle : public AmoebotParticle {
   // compass direction from its head to its tail (-1 if contracted), an offset
   // for its local compass, a system which it belongs to, a capacity for its
   // battery, an energy demand for its actions, an energy transfer rate, an
-  // energy usage mode, and a state.
+  // energy usage mode, a state, and the system's action count to record to.
   EnergySharingParticle(const Node& head, int globalTailDir,
                         const int orientation, AmoebotSystem& system,
                         const double capacity, const double demand,
                         const double transferRate, const Usage usage,
-                        const State state);
+                        const State state, Count& actionCount);
 
   // Executes one particle activation.
   void activate() override;
@@ -76,6 +77,7 @@ class EnergySharingParticle : public AmoebotParticle {
   const double _demand;
   const double _transferRate;
   const Usage _usage;
+  Count& _actionCount;
 
   // Local variables.
   double _battery;
@@ -90,7 +92,7 @@ class EnergySharingParticle : public AmoebotParticle {
   friend class EnergySharingSystem;
 };
 
-class EnergySharingSystem : public AmoebotSystem {
+class EnergySharingSystem : public TypedAmoebotSystem<EnergySharingParticle> {
  public:
   // Constructs a system of EnergySharingParticles with an optionally specified
   // size (# particles), number of energy roots, energy usage mode (0 for
@@ -7,8 +7,8 @@
 HexagonFormationParticle::HexagonFormationParticle(const Node head,
                                                    AmoebotSystem& system,
                                                    const State state)
-    : AmoebotParticle(head, -1, randDir(), system),
-      _state(state),
+    : AmoebotParticle(head, -1, system.randDir(), system),
+      _state(system.stateCounter<State>(), state),
       _parentDir(-1),
       _hexagonDir(state == State::Seed ? 0 : -1) {}
 
@@ -203,8 +203,8 @@ HexagonFormationSystem::HexagonFormationSystem(int numParticles,
                                                double holeProb) {
   // Insert the shape formation seed at (0,0).
   std::set<Node> occupied;
-  insert(new HexagonFormationParticle(Node(0, 0), *this,
-                                      HexagonFormationParticle::State::Seed));
+  insert(newParticle<HexagonFormationParticle>(
+      Node(0, 0), *this, HexagonFormationParticle::State::Seed));
   occupied.insert(Node(0, 0));
 
   // Initialize the candidate positions set.
@@ -231,7 +231,7 @@ HexagonFormationSystem::HexagonFormationSystem(int numParticles,
 
     // With probability 1 - holeProb, add a new particle at the candidate node.
     if (randBool(1.0 - holeProb)) {
-      insert(new HexagonFormationParticle(
+      insert(newParticle<HexagonFormationParticle>(
           randCand, *this, HexagonFormationParticle::State::Idle));
       occupied.insert(randCand);
       particlesAdded++;
@@ -247,12 +247,7 @@ HexagonFormationSystem::HexagonFormationSystem(int numParticles,
 }
 
 bool HexagonFormationSystem::hasTerminated() const {
-  for (auto p : particles) {
-    auto hp = dynamic_cast<HexagonFormationParticle*>(p);
-    if (hp->_state != HexagonFormationParticle::State::Seed
-        && hp->_state != HexagonFormationParticle::State::Retired)
-      return false;
-  }
-
-  return true;
+  using State = HexagonFormationParticle::State;
+  const auto& states = stateCounter<State>();
+  return states.count({State::Seed, State::Retired}) == states.total();
 }
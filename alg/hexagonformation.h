@@ -16,6 +16,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class HexagonFormationParticle : public AmoebotParticle {
  public:
@@ -83,7 +84,7 @@ class HexagonFormationParticle : public AmoebotParticle {
 
  protected:
   // Particle memory.
-  State _state;
+  CountedState<State> _state;
   int _parentDir;   // Corresponds to "parent" in paper.
   int _hexagonDir;  // Corresponds to "dir" in paper.
 
@@ -91,7 +92,8 @@ class HexagonFormationParticle : public AmoebotParticle {
   friend class HexagonFormationSystem;
 };
 
-class HexagonFormationSystem : public AmoebotSystem {
+class HexagonFormationSystem
+    : public TypedAmoebotSystem<HexagonFormationParticle> {
  public:
   // Constructs a system of HexagonFormationParticles with an optionally
   // specified size (#particles) and hole probability in [0,1) controlling how
@@ -4,6 +4,7 @@
 
 #include "alg/infobjcoating.h"
 
+#include <cmath>
 #include <set>
 
 InfObjCoatingParticle::InfObjCoatingParticle(const Node head,
@@ -11,7 +12,7 @@ InfObjCoatingParticle::InfObjCoatingParticle(const Node head,
                                              const int orientation,
                                              AmoebotSystem &system, State state)
   : AmoebotParticle(head, globalTailDir, orientation, system),
-    state(state),
+    state(system.stateCounter<State>(), state),
     moveDir(-1) {}
 
 void InfObjCoatingParticle::activate() {
@@ -54,7 +55,7 @@ void InfObjCoatingParticle::activate() {
       } else if (hasTailAtLabel(moveDir)) {
         // If a follower's parent is expanded, handover expand with it. Update
         // moveDir to continue to point at the parent after the handover.
-        auto nbr = nbrAtLabel(moveDir);
+        auto& nbr = nbrAtLabel(moveDir);
         int nbrContractDir = nbrDirToDir(nbr, (nbr.tailDir() + 3) % 6);
         push(moveDir);
         moveDir = nbrContractDir;
@@ -63,7 +64,7 @@ void InfObjCoatingParticle::activate() {
     } else if (state == State::Leader) {
       // If has a follower child, generate a complaint token if not holding one.
       if (hasFollowerChild() && !hasToken<ComplaintToken>()) {
-        putToken(std::make_shared<ComplaintToken>());
+        putToken(makeToken<ComplaintToken>());
       }
 
       // Only act if holding a complaint token.
@@ -226,8 +227,9 @@ InfObjCoatingSystem::InfObjCoatingSystem(uint numParticles, double holeProb) {
     for (auto candPos : candidates) {
       // Place a particle at the candidate position with probability 1 - hole.
       if (particleNodes.size() < numParticles && randBool(1 - holeProb)) {
-        insert(new InfObjCoatingParticle(candPos, -1, randDir(), *this,
-                                       InfObjCoatingParticle::State::Inactive));
+        insert(newParticle<InfObjCoatingParticle>(
+            candPos, -1, randDir(), *this,
+            InfObjCoatingParticle::State::Inactive));
         particleNodes.insert(candPos);
         lastAdded.insert(candPos);
       }
@@ -254,9 +256,15 @@ InfObjCoatingSystem::InfObjCoatingSystem(uint numParticles, double holeProb) {
 
 bool InfObjCoatingSystem::hasTerminated() const {
   // Algorithm is terminated if all particles are on the surface (leaders) and
-  // have contracted.
-  for (auto p : particles) {
-    auto iocp = dynamic_cast<InfObjCoatingParticle*>(p);
+  // have contracted. Until every particle is a leader, the state counter rules
+  // termination out without scanning for outstanding complaints.
+  using State = InfObjCoatingParticle::State;
+  const auto& states = stateCounter<State>();
+  if (states.count(State::Leader) != states.total()) {
+    return false;
+  }
+
+  for (auto iocp : typedParticles()) {
     if ((iocp->state != InfObjCoatingParticle::State::Leader) ||
         iocp->hasToken<InfObjCoatingParticle::ComplaintToken>()) {
       return false;
@@ -16,6 +16,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class InfObjCoatingParticle : public AmoebotParticle {
  public:
@@ -76,14 +77,14 @@ class InfObjCoatingParticle : public AmoebotParticle {
   struct ComplaintToken : public Token {};
 
   // Particle memory.
-  State state;
+  CountedState<State> state;
   int moveDir;
 
  private:
   friend class InfObjCoatingSystem;
 };
 
-class InfObjCoatingSystem : public AmoebotSystem {
+class InfObjCoatingSystem : public TypedAmoebotSystem<InfObjCoatingParticle> {
  public:
   // Constructs a system of InfObjCoatingParticles connected to a randomly
   // generated surface (with no tunnels). Takes an optionally specified size
@@ -16,7 +16,7 @@ LeaderElectionParticle::LeaderElectionParticle(const Node head,
                                                AmoebotSystem& system,
                                                State state)
   : AmoebotParticle(head, globalTailDir, orientation, system),
-    state(state),
+    state(system.stateCounter<State>(), state),
     currentAgent(0) {
   borderColorLabels.fill(-1);
   borderPointColorLabels.fill(-1);
@@ -206,13 +206,7 @@ int LeaderElectionParticle::getPrevAgentDir(const int agentDir) const {
 }
 
 int LeaderElectionParticle::getNumberOfNbrs() const {
-  int count = 0;
-  for (int dir = 0; dir < 6; dir++) {
-    if (hasNbrAtLabel(dir)) {
-      count++;
-    }
-  }
-  return count;
+  return numLabelsIn(nbrLabelMask() & 63);
 }
 
 //----------------------------END PARTICLE CODE----------------------------
@@ -228,7 +222,7 @@ LeaderElectionParticle::LeaderElectionAgent::LeaderElectionAgent() :
   candidateParticle(nullptr) {}
 
 void LeaderElectionParticle::LeaderElectionAgent::activate() {
-  passTokensDir = randInt(0, 2);
+  passTokensDir = candidateParticle->randInt(0, 2);
   if (agentState == State::Candidate) {
     // Segment Comparison
     if (hasAgentToken<ActiveSegmentCleanToken>(nextAgentDir)) {
@@ -247,7 +241,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
         takeAgentToken<SegmentLeadToken>(prevAgentDir);
         passAgentToken<PassiveSegmentToken>
             (prevAgentDir,
-             std::make_shared<PassiveSegmentToken>(-1, true));
+             makeToken<PassiveSegmentToken>(-1, true));
         paintBackSegment(0x696969);
       }
     }
@@ -261,16 +255,16 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
           takeAgentToken<ActiveSegmentToken>(nextAgentDir);
           passAgentToken<FinalSegmentCleanToken>
               (nextAgentDir,
-               std::make_shared<FinalSegmentCleanToken>(-1, true));
+               makeToken<FinalSegmentCleanToken>(-1, true));
         } else if (next != nullptr &&
                    !next->hasAgentToken<PassiveSegmentCleanToken>
                    (next->prevAgentDir)) {
           passAgentToken<PassiveSegmentCleanToken>
-              (nextAgentDir, std::make_shared<PassiveSegmentCleanToken>());
+              (nextAgentDir, makeToken<PassiveSegmentCleanToken>());
           passiveClean(true);
           generatedCleanToken = true;
           candidateParticle->putToken
-              (std::make_shared<ActiveSegmentCleanToken>(nextAgentDir));
+              (makeToken<ActiveSegmentCleanToken>(nextAgentDir));
           activeClean(true);
           absorbedActiveToken = true;
           isCoveredCandidate = true;
@@ -281,7 +275,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
       } else {
         Q_ASSERT(false);
         passAgentToken<ActiveSegmentToken>
-            (prevAgentDir, std::make_shared<ActiveSegmentToken>());
+            (prevAgentDir, makeToken<ActiveSegmentToken>());
       }
     }
 
@@ -290,7 +284,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
         passTokensDir == 1) {
       takeAgentToken<CandidacyAnnounceToken>(prevAgentDir);
       passAgentToken<CandidacyAckToken>
-          (prevAgentDir, std::make_shared<CandidacyAckToken>());
+          (prevAgentDir, makeToken<CandidacyAckToken>());
       paintBackSegment(0x696969);
       if (waitingForTransferAck) {
         gotAnnounceBeforeAck = true;
@@ -341,7 +335,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
               takeAgentToken<PassiveSegmentToken>(nextAgentDir)->isFinal;
           passAgentToken<ActiveSegmentToken>
               (prevAgentDir,
-               std::make_shared<ActiveSegmentToken>(-1, isFinalCheck));
+               makeToken<ActiveSegmentToken>(-1, isFinalCheck));
           if (isFinalCheck) {
             paintFrontSegment(0x696969);
           }
@@ -362,7 +356,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
         return;
       } else if (!comparingSegment && passTokensDir == 0) {
         passAgentToken<SegmentLeadToken>
-            (nextAgentDir, std::make_shared<SegmentLeadToken>());
+            (nextAgentDir, makeToken<SegmentLeadToken>());
         paintFrontSegment(0xff0000);
         comparingSegment = true;
       }
@@ -379,18 +373,19 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
         waitingForTransferAck = false;
         gotAnnounceBeforeAck = false;
         return;
-      } else if (!waitingForTransferAck && passTokensDir == 0 && randBool()) {
+      } else if (!waitingForTransferAck && passTokensDir == 0 &&
+                 candidateParticle->randBool()) {
         passAgentToken<CandidacyAnnounceToken>
-            (nextAgentDir, std::make_shared<CandidacyAnnounceToken>());
+            (nextAgentDir, makeToken<CandidacyAnnounceToken>());
         paintFrontSegment(0xffa500);
         waitingForTransferAck = true;
       }
     } else if (subPhase == SubPhase::SolitudeVerification) {
       if (!createdLead && passTokensDir == 0) {
         passAgentToken<SolitudeActiveToken>
-            (nextAgentDir, std::make_shared<SolitudeActiveToken>());
+            (nextAgentDir, makeToken<SolitudeActiveToken>());
         candidateParticle->putToken
-            (std::make_shared<SolitudePositiveXToken>(nextAgentDir, true));
+            (makeToken<SolitudePositiveXToken>(nextAgentDir, true));
         paintFrontSegment(0x00bfff);
         createdLead = true;
         hasGeneratedTokens = true;
@@ -458,7 +453,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
       passAgentToken<SegmentLeadToken>
           (nextAgentDir, takeAgentToken<SegmentLeadToken>(prevAgentDir));
       candidateParticle->putToken(
-            std::make_shared<PassiveSegmentToken>(nextAgentDir, false));
+            makeToken<PassiveSegmentToken>(nextAgentDir, false));
       paintBackSegment(0xff0000);
       paintFrontSegment(0xff0000);
     }
@@ -476,7 +471,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
       if (passTokensDir == 0 && !absorbedActiveToken) {
         if (takeAgentToken<ActiveSegmentToken>(nextAgentDir)->isFinal) {
           passAgentToken<FinalSegmentCleanToken>
-              (nextAgentDir, std::make_shared<FinalSegmentCleanToken>());
+              (nextAgentDir, makeToken<FinalSegmentCleanToken>());
         } else {
           absorbedActiveToken = true;
         }
@@ -638,7 +633,7 @@ void LeaderElectionParticle::LeaderElectionAgent::activate() {
   } else if (agentState == State::SoleCandidate) {
     if (!testingBorder) {
       std::shared_ptr<BorderTestToken> token =
-          std::make_shared<BorderTestToken>(prevAgentDir, addNextBorder(0));
+          makeToken<BorderTestToken>(prevAgentDir, addNextBorder(0));
       passAgentToken(nextAgentDir, token);
       paintFrontSegment(-1);
       testingBorder = true;
@@ -753,13 +748,13 @@ generateSolitudeVectorTokens(std::pair<int, int> vector) {
   switch(vector.first) {
     case -1:
       candidateParticle->putToken
-          (std::make_shared<SolitudeNegativeXToken>(nextAgentDir, false));
+          (makeToken<SolitudeNegativeXToken>(nextAgentDir, false));
       break;
     case 0:
       break;
     case 1:
       candidateParticle->putToken
-          (std::make_shared<SolitudePositiveXToken>(nextAgentDir, false));
+          (makeToken<SolitudePositiveXToken>(nextAgentDir, false));
       break;
     default:
       Q_ASSERT(false);
@@ -768,13 +763,13 @@ generateSolitudeVectorTokens(std::pair<int, int> vector) {
   switch(vector.second) {
     case -1:
       candidateParticle->putToken
-          (std::make_shared<SolitudeNegativeYToken>(nextAgentDir, false));
+          (makeToken<SolitudeNegativeYToken>(nextAgentDir, false));
       break;
     case 0:
       break;
     case 1:
       candidateParticle->putToken
-          (std::make_shared<SolitudePositiveYToken>(nextAgentDir, false));
+          (makeToken<SolitudePositiveYToken>(nextAgentDir, false));
       break;
     default:
       Q_ASSERT(false);
@@ -910,6 +905,12 @@ passAgentToken(int agentDir, std::shared_ptr<TokenType> token) {
   nbr->putToken(token);
 }
 
+template <class TokenType, class... Args>
+std::shared_ptr<TokenType>
+LeaderElectionParticle::LeaderElectionAgent::makeToken(Args&&... args) const {
+  return candidateParticle->makeToken<TokenType>(std::forward<Args>(args)...);
+}
+
 LeaderElectionParticle::LeaderElectionAgent*
 LeaderElectionParticle::LeaderElectionAgent::nextAgent() const {
   LeaderElectionParticle* nextNbr =
@@ -1029,8 +1030,8 @@ LeaderElectionSystem::LeaderElectionSystem(int numParticles, double holeProb) {
   Q_ASSERT(0 <= holeProb && holeProb <= 1);
 
   // Insert the seed at (0,0).
-  insert(new LeaderElectionParticle(Node(0, 0), -1, randDir(), *this,
-                                    LeaderElectionParticle::State::Idle));
+  insert(newParticle<LeaderElectionParticle>(
+      Node(0, 0), -1, randDir(), *this, LeaderElectionParticle::State::Idle));
   std::set<Node> occupied;
   occupied.insert(Node(0, 0));
 
@@ -1059,8 +1060,9 @@ LeaderElectionSystem::LeaderElectionSystem(int numParticles, double holeProb) {
 
     // Add this candidate as a particle if not a hole.
     if (randBool(1.0 - holeProb)) {
-      insert(new LeaderElectionParticle(randomCandidate, -1, randDir(), *this,
-                                        LeaderElectionParticle::State::Idle));
+      insert(newParticle<LeaderElectionParticle>(
+          randomCandidate, -1, randDir(), *this,
+          LeaderElectionParticle::State::Idle));
       ++numNonStaticParticles;
 
       // Add new candidates.
@@ -1076,18 +1078,12 @@ LeaderElectionSystem::LeaderElectionSystem(int numParticles, double holeProb) {
 
 bool LeaderElectionSystem::hasTerminated() const {
   #ifdef QT_DEBUG
-    if (!isConnected(particles)) {
+    if (!isConnected()) {
       return true;
     }
   #endif
 
-  for (auto p : particles) {
-    auto hp = dynamic_cast<LeaderElectionParticle*>(p);
-    if (hp->state != LeaderElectionParticle::State::Leader &&
-        hp->state != LeaderElectionParticle::State::Finished) {
-      return false;
-    }
-  }
-
-  return true;
+  using State = LeaderElectionParticle::State;
+  const auto& states = stateCounter<State>();
+  return states.count({State::Leader, State::Finished}) == states.total();
 }
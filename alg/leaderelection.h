@@ -34,6 +34,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class LeaderElectionParticle : public AmoebotParticle {
  public:
@@ -341,6 +342,8 @@ class LeaderElectionParticle : public AmoebotParticle {
     std::shared_ptr<TokenType> takeAgentToken(int agentDir);
     template <class TokenType>
     void passAgentToken(int agentDir, std::shared_ptr<TokenType> token);
+    template <class TokenType, class... Args>
+    std::shared_ptr<TokenType> makeToken(Args&&... args) const;
     LeaderElectionAgent* nextAgent() const;
     LeaderElectionAgent* prevAgent() const;
 
@@ -367,14 +370,14 @@ class LeaderElectionParticle : public AmoebotParticle {
   };
 
   protected:
-   State state;
+   CountedState<State> state;
    unsigned int currentAgent;
    std::vector<LeaderElectionAgent*> agents;
    std::array<int, 18> borderColorLabels;
    std::array<int, 6> borderPointColorLabels;
 };
 
-class LeaderElectionSystem : public AmoebotSystem {
+class LeaderElectionSystem : public TypedAmoebotSystem<LeaderElectionParticle> {
  public:
   // Constructs a system of LeaderElectionParticles with an optionally specified
   // size (#particles), and hole probability. holeProb in [0,1] controls how
@@ -6,8 +6,8 @@
 
 LeaderElectionByErosionParticle::LeaderElectionByErosionParticle(
   const Node head, AmoebotSystem &system)
-    : AmoebotParticle(head, -1, randDir(), system),
-      _state(State::Null) {}
+    : AmoebotParticle(head, -1, system.randDir(), system),
+      _state(system.stateCounter<State>(), State::Null) {}
 
 void LeaderElectionByErosionParticle::activate() {
   if (_state == State::Null) {  // "Setup" action.
@@ -85,54 +85,29 @@ bool LeaderElectionByErosionParticle::hasNbrInState(
 }
 
 bool LeaderElectionByErosionParticle::canErode() const {
-  // First, count the number of candidate neighbors.
-  uint numCandNbrs = 0;
-  for (int label : uniqueLabels()) {
-    if (hasNbrAtLabel(label) && nbrAtLabel(label)._state == State::Candidate)
-      ++numCandNbrs;
+  // First, collect the labels of candidate neighbors into a mask. Note that
+  // it's okay in this particular case to hardcode the upper limit of 6
+  // (distinct) labels since particles are instantiated as contracted and never
+  // move.
+  const int nbrs = nbrLabelMask();
+  int candNbrs = 0;
+  for (int label = 0; label < 6; ++label) {
+    if (((nbrs >> label) & 1) && nbrAtLabel(label)._state == State::Candidate) {
+      candNbrs |= 1 << label;
+    }
   }
+  const int numCandNbrs = numLabelsIn(candNbrs);
 
   // Rule 1: Return true if there is exactly one candidate neighbor.
   if (numCandNbrs == 1)
     return true;
 
-  // Otherwise, determine if the candidate neighbors form a connected component.
-  if (numCandNbrs > 0) {
-    // Find any candidate neighbor.
-    int candLabel = labelOfFirstNbrInState({State::Candidate});
-    std::set<int> connectedCandLabels = {candLabel};
-
-    // Sweep counter-clockwise from this candidate, stopping when an unoccupied
-    // position or non-candidate neighbor is encountered. Note that it's okay in
-    // this particular case to hardcode the upper limit of 6 (distinct) labels
-    // since particles are instantiated as contracted and never move.
-    for (uint offset = 1; offset < 6; ++offset) {
-      int label = (candLabel + offset) % 6;
-      if (hasNbrAtLabel(label) && nbrAtLabel(label)._state == State::Candidate){
-        connectedCandLabels.insert(label);
-      } else {
-        break;
-      }
-    }
-
-    // Then do the same but in the clockwise direction.
-    for (uint offset = 1; offset < 6; ++offset) {
-      int label = (candLabel - offset + 6) % 6;
-      if (hasNbrAtLabel(label) && nbrAtLabel(label)._state == State::Candidate){
-        connectedCandLabels.insert(label);
-      } else {
-        break;
-      }
-    }
-
-    // Rule 2: Return true if there are 2 to 5 candidate neighbors that form a
-    // connected component.
-    return numCandNbrs >= 2 && numCandNbrs <= 5
-           && numCandNbrs == connectedCandLabels.size();
-  }
-
-  // Otherwise, this particle cannot erode.
-  return false;
+  // Rule 2: Return true if there are 2 to 5 candidate neighbors that form a
+  // connected component, i.e., exactly one of them does not have a candidate
+  // neighbor at the next label clockwise.
+  const int cwCandNbrs = ((candNbrs << 1) | (candNbrs >> 5)) & 63;
+  return numCandNbrs >= 2 && numCandNbrs <= 5
+         && numLabelsIn(candNbrs & ~cwCandNbrs) == 1;
 }
 
 LeaderElectionByErosionSystem::LeaderElectionByErosionSystem(int numParticles) {
@@ -179,16 +154,11 @@ LeaderElectionByErosionSystem::LeaderElectionByErosionSystem(int numParticles) {
       }
     }
 
-    insert(new LeaderElectionByErosionParticle(Node(x, y), *this));
+    insert(newParticle<LeaderElectionByErosionParticle>(Node(x, y), *this));
   }
 }
 
 bool LeaderElectionByErosionSystem::hasTerminated() const {
-  for (auto p : particles) {
-    auto lep = dynamic_cast<LeaderElectionByErosionParticle*>(p);
-    if (lep->_state == LeaderElectionByErosionParticle::State::Leader)
-      return true;
-  }
-
-  return false;
+  using State = LeaderElectionByErosionParticle::State;
+  return stateCounter<State>().count(State::Leader) > 0;
 }
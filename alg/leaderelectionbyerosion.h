@@ -17,6 +17,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class LeaderElectionByErosionParticle : public AmoebotParticle {
  public:
@@ -64,13 +65,14 @@ class LeaderElectionByErosionParticle : public AmoebotParticle {
 
  protected:
   // Particle memory.
-  State _state;
+  CountedState<State> _state;
 
  private:
   friend class LeaderElectionByErosionSystem;
 };
 
-class LeaderElectionByErosionSystem : public AmoebotSystem {
+class LeaderElectionByErosionSystem
+    : public TypedAmoebotSystem<LeaderElectionByErosionParticle> {
  public:
   // Constructs a system of LeaderElectionByErosionParticles with an optionally
   // specified size (#particles) in the shape of a hexagon, since this algorithm
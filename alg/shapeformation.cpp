@@ -12,7 +12,7 @@ ShapeFormationParticle::ShapeFormationParticle(const Node head,
                                                AmoebotSystem& system,
                                                State state, const QString mode)
   : AmoebotParticle(head, globalTailDir, orientation, system),
-    state(state),
+    state(system.stateCounter<State>(), state),
     mode(mode),
     constructionDir(-1),
     moveDir(-1),
@@ -57,7 +57,7 @@ void ShapeFormationParticle::activate() {
         updateMoveDir();
         return;
       } else if (hasTailAtLabel(followDir)) {
-        auto nbr = nbrAtLabel(followDir);
+        auto& nbr = nbrAtLabel(followDir);
         int nbrContractionDir = nbrDirToDir(nbr, (nbr.tailDir() + 3) % 6);
         push(followDir);
         followDir = nbrContractionDir;
@@ -309,8 +309,9 @@ ShapeFormationSystem::ShapeFormationSystem(int numParticles, double holeProb,
 
   // Insert the seed at (0,0).
   std::set<Node> occupied;
-  insert(new ShapeFormationParticle(Node(0, 0), -1, randDir(), *this,
-                                    ShapeFormationParticle::State::Seed, mode));
+  insert(newParticle<ShapeFormationParticle>(
+      Node(0, 0), -1, randDir(), *this, ShapeFormationParticle::State::Seed,
+      mode));
   occupied.insert(Node(0, 0));
 
   std::set<Node> candidates;
@@ -336,9 +337,9 @@ ShapeFormationSystem::ShapeFormationSystem(int numParticles, double holeProb,
 
     // With probability 1 - holeProb, add a new particle at the candidate node.
     if (randBool(1.0 - holeProb)) {
-      insert(new ShapeFormationParticle(randCand, -1, randDir(), *this,
-                                        ShapeFormationParticle::State::Idle,
-                                        mode));
+      insert(newParticle<ShapeFormationParticle>(
+          randCand, -1, randDir(), *this, ShapeFormationParticle::State::Idle,
+          mode));
       occupied.insert(randCand);
       particlesAdded++;
 
@@ -354,20 +355,14 @@ ShapeFormationSystem::ShapeFormationSystem(int numParticles, double holeProb,
 
 bool ShapeFormationSystem::hasTerminated() const {
   #ifdef QT_DEBUG
-    if (!isConnected(particles)) {
+    if (!isConnected()) {
       return true;
     }
   #endif
 
-  for (auto p : particles) {
-    auto hp = dynamic_cast<ShapeFormationParticle*>(p);
-    if (hp->state != ShapeFormationParticle::State::Seed &&
-        hp->state != ShapeFormationParticle::State::Finish) {
-      return false;
-    }
-  }
-
-  return true;
+  using State = ShapeFormationParticle::State;
+  const auto& states = stateCounter<State>();
+  return states.count({State::Seed, State::Finish}) == states.total();
 }
 
 std::set<QString> ShapeFormationSystem::getAcceptedModes() {
@@ -22,6 +22,7 @@
 
 #include "core/amoebotparticle.h"
 #include "core/amoebotsystem.h"
+#include "core/typedamoebotsystem.h"
 
 class ShapeFormationParticle : public AmoebotParticle {
  public:
@@ -92,7 +93,7 @@ class ShapeFormationParticle : public AmoebotParticle {
   bool hasTailFollower() const;
 
  protected:
-  State state;
+  CountedState<State> state;
   QString mode;
   int turnSignal;
   int constructionDir;
@@ -103,7 +104,7 @@ class ShapeFormationParticle : public AmoebotParticle {
   friend class ShapeFormationSystem;
 };
 
-class ShapeFormationSystem : public AmoebotSystem  {
+class ShapeFormationSystem : public TypedAmoebotSystem<ShapeFormationParticle> {
  public:
   // Constructs a system of ShapeFormationParticles with an optionally specified
   // size (#particles), hole probability, and shape to form. holeProb in [0,1]
@@ -0,0 +1,15 @@
+# Links a target against the amoebotcore static library. Include this from a
+# subproject's .pro file after setting its QT modules.
+
+QT          += core
+INCLUDEPATH += $$PWD/..
+DEPENDPATH  += $$PWD/..
+
+win32:CONFIG(release, debug|release): AMOEBOTCORE_DIR = $$OUT_PWD/../amoebotcore/release
+else:win32:CONFIG(debug, debug|release): AMOEBOTCORE_DIR = $$OUT_PWD/../amoebotcore/debug
+else: AMOEBOTCORE_DIR = $$OUT_PWD/../amoebotcore
+
+LIBS += -L$$AMOEBOTCORE_DIR -lamoebotcore
+
+win32-msvc*: PRE_TARGETDEPS += $$AMOEBOTCORE_DIR/amoebotcore.lib
+else: PRE_TARGETDEPS += $$AMOEBOTCORE_DIR/libamoebotcore.a
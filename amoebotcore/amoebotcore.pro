@@ -0,0 +1,87 @@
+QT       = core
+CONFIG  += c++11 staticlib
+TARGET    = amoebotcore
+TEMPLATE  = lib
+
+INCLUDEPATH += ..
+
+HEADERS += \
+    ../alg/demo/ballroomdemo.h \
+    ../alg/demo/discodemo.h \
+    ../alg/demo/dynamicdemo.h \
+    ../alg/demo/metricsdemo.h \
+    ../alg/demo/tokendemo.h \
+    ../alg/aggregation.h \
+    ../alg/compression.h \
+    ../alg/compressionbitboard.h \
+    ../alg/compressiontempering.h \
+    ../alg/edfhexagonformation.h \
+    ../alg/edfleaderelectionbyerosion.h \
+    ../alg/energyshape.h \
+    ../alg/energysharing.h \
+    ../alg/hexagonformation.h \
+    ../alg/infobjcoating.h \
+    ../alg/leaderelection.h \
+    ../alg/leaderelectionbyerosion.h \
+    ../alg/shapeformation.h \
+    ../core/amoebotparticle.h \
+    ../core/amoebotsystem.h \
+    ../core/bitlattice.h \
+    ../core/clusteranalysis.h \
+    ../core/connectivitymonitor.h \
+    ../core/ensemble.h \
+    ../core/geometry.h \
+    ../core/lattice.h \
+    ../core/localparticle.h \
+    ../core/memorypool.h \
+    ../core/metric.h \
+    ../core/node.h \
+    ../core/object.h \
+    ../core/particle.h \
+    ../core/sectorindex.h \
+    ../core/simulator.h \
+    ../core/snapshot.h \
+    ../core/statecounter.h \
+    ../core/system.h \
+    ../core/tiledirectory.h \
+    ../core/tokenstore.h \
+    ../core/typedamoebotsystem.h \
+    ../helper/randomnumbergenerator.h \
+    ../ui/algorithm.h
+
+SOURCES += \
+    ../alg/demo/ballroomdemo.cpp \
+    ../alg/demo/discodemo.cpp \
+    ../alg/demo/dynamicdemo.cpp \
+    ../alg/demo/metricsdemo.cpp \
+    ../alg/demo/tokendemo.cpp \
+    ../alg/aggregation.cpp \
+    ../alg/compression.cpp \
+    ../alg/compressionbitboard.cpp \
+    ../alg/compressiontempering.cpp \
+    ../alg/edfhexagonformation.cpp \
+    ../alg/edfleaderelectionbyerosion.cpp \
+    ../alg/energyshape.cpp \
+    ../alg/energysharing.cpp \
+    ../alg/hexagonformation.cpp \
+    ../alg/infobjcoating.cpp \
+    ../alg/leaderelection.cpp \
+    ../alg/leaderelectionbyerosion.cpp \
+    ../alg/shapeformation.cpp \
+    ../core/amoebotparticle.cpp \
+    ../core/amoebotsystem.cpp \
+    ../core/clusteranalysis.cpp \
+    ../core/ensemble.cpp \
+    ../core/geometry.cpp \
+    ../core/localparticle.cpp \
+    ../core/memorypool.cpp \
+    ../core/metric.cpp \
+    ../core/object.cpp \
+    ../core/particle.cpp \
+    ../core/sectorindex.cpp \
+    ../core/simulator.cpp \
+    ../core/snapshot.cpp \
+    ../core/system.cpp \
+    ../core/tokenstore.cpp \
+    ../helper/randomnumbergenerator.cpp \
+    ../ui/algorithm.cpp
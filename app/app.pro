@@ -0,0 +1,40 @@
+QT      += core gui qml quick
+CONFIG  += c++11
+TARGET    = AmoebotSim
+TEMPLATE  = app
+
+include(../amoebotcore/amoebotcore.pri)
+
+macx:ICON = ../res/icon/icon.icns
+QMAKE_INFO_PLIST = ../res/Info.plist
+
+win32:RC_FILE = ../res/AmoebotSim.rc
+
+HEADERS += \
+    ../main/application.h \
+    ../script/scriptengine.h \
+    ../script/scriptinterface.h \
+    ../ui/glitem.h \
+    ../ui/parameterlistmodel.h \
+    ../ui/view.h \
+    ../ui/visitem.h
+
+SOURCES += \
+    ../main/application.cpp \
+    ../main/main.cpp \
+    ../script/scriptengine.cpp \
+    ../script/scriptinterface.cpp \
+    ../ui/glitem.cpp \
+    ../ui/parameterlistmodel.cpp \
+    ../ui/view.cpp \
+    ../ui/visitem.cpp
+
+RESOURCES += \
+    ../res/qml.qrc \
+    ../res/textures.qrc
+
+OTHER_FILES += \
+    ../res/qml/A_Button.qml \
+    ../res/qml/A_Inspector.qml \
+    ../res/qml/A_ResultTextField.qml \
+    ../res/qml/main.qml
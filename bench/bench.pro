@@ -0,0 +1,10 @@
+QT       = core
+CONFIG  += c++11 console
+CONFIG  -= app_bundle
+TARGET    = latticebench
+TEMPLATE  = app
+
+include(../amoebotcore/amoebotcore.pri)
+
+SOURCES += \
+    latticebench.cpp
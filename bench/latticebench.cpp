@@ -0,0 +1,151 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Compares the tiled Lattice occupancy store against the std::map<Node, ...>
+// lookups it replaced. A hexagonal blob of particles is placed around the
+// origin and then probed with the same access pattern an activation uses:
+// pick a random occupied node and test all six of its neighbors, either one
+// by one or by reading the node's neighborhood mask. A second phase moves
+// particles one step at a time to measure write throughput.
+//
+// Usage: latticebench [#particles] [#probes]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "core/lattice.h"
+#include "core/node.h"
+
+namespace {
+
+struct BenchParticle { int id; };
+
+// Returns the nodes of a compact hexagonal blob of the given size, built layer
+// by layer the same way the algorithm constructors lay out their particles.
+std::vector<Node> hexagonNodes(int numNodes) {
+  std::vector<Node> nodes;
+  std::map<Node, bool> seen;
+  std::vector<Node> frontier = {Node(0, 0)};
+  seen[Node(0, 0)] = true;
+  for (size_t i = 0; i < frontier.size() && (int)nodes.size() < numNodes; ++i) {
+    nodes.push_back(frontier[i]);
+    for (int dir = 0; dir < 6; ++dir) {
+      Node nbr = frontier[i].nodeInDir(dir);
+      if (!seen[nbr]) {
+        seen[nbr] = true;
+        frontier.push_back(nbr);
+      }
+    }
+  }
+
+  return nodes;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const int numParticles = (argc > 1) ? std::atoi(argv[1]) : 100000;
+  const int numProbes = (argc > 2) ? std::atoi(argv[2]) : 10000000;
+
+  std::vector<Node> nodes = hexagonNodes(numParticles);
+  std::vector<BenchParticle> particles(nodes.size());
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> pick(0, nodes.size() - 1);
+  std::vector<int> order(numProbes);
+  for (auto& i : order) {
+    i = pick(rng);
+  }
+
+  std::map<Node, BenchParticle*> map;
+  Lattice<BenchParticle> lattice;
+
+  // Insertion.
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    map[nodes[i]] = &particles[i];
+  }
+  const double mapInsert = secondsSince(start);
+
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    lattice.setParticleAt(nodes[i], &particles[i]);
+  }
+  const double latticeInsert = secondsSince(start);
+
+  // Neighborhood probes.
+  long mapHits = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i : order) {
+    for (int dir = 0; dir < 6; ++dir) {
+      mapHits += map.find(nodes[i].nodeInDir(dir)) != map.end();
+    }
+  }
+  const double mapProbe = secondsSince(start);
+
+  long latticeHits = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i : order) {
+    for (int dir = 0; dir < 6; ++dir) {
+      latticeHits += lattice.hasParticleAt(nodes[i].nodeInDir(dir));
+    }
+  }
+  const double latticeProbe = secondsSince(start);
+
+  long maskHits = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i : order) {
+    const unsigned int mask = lattice.nbrMask(nodes[i]);
+    for (int dir = 0; dir < 6; ++dir) {
+      maskHits += (mask >> dir) & 1;
+    }
+  }
+  const double maskProbe = secondsSince(start);
+
+  // Moves: vacate a node and reoccupy it, as a contraction and expansion would.
+  start = std::chrono::steady_clock::now();
+  for (int i : order) {
+    BenchParticle* p = map[nodes[i]];
+    map.erase(nodes[i]);
+    map[nodes[i]] = p;
+  }
+  const double mapMove = secondsSince(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i : order) {
+    BenchParticle* p = lattice.particleAt(nodes[i]);
+    lattice.clearParticleAt(nodes[i]);
+    lattice.setParticleAt(nodes[i], p);
+  }
+  const double latticeMove = secondsSince(start);
+
+  if (mapHits != latticeHits || mapHits != maskHits) {
+    std::fprintf(stderr, "mismatch: map saw %ld neighbors, lattice saw %ld, "
+                 "masks saw %ld\n", mapHits, latticeHits, maskHits);
+    return 1;
+  }
+
+  std::printf("%zu particles, %d probes, %u tiles\n", nodes.size(), numProbes,
+              lattice.numTiles());
+  std::printf("%-10s %12s %12s %12s\n", "", "insert (s)", "probe (s)",
+              "move (s)");
+  std::printf("%-10s %12.4f %12.4f %12.4f\n", "std::map", mapInsert, mapProbe,
+              mapMove);
+  std::printf("%-10s %12.4f %12.4f %12.4f\n", "Lattice", latticeInsert,
+              latticeProbe, latticeMove);
+  std::printf("%-10s %12s %12.4f\n", "nbrMask", "", maskProbe);
+  std::printf("%-10s %12.1fx %11.1fx %11.1fx\n", "speedup",
+              mapInsert / latticeInsert, mapProbe / latticeProbe,
+              mapMove / latticeMove);
+
+  return 0;
+}
@@ -4,10 +4,15 @@
 
 #include "core/amoebotparticle.h"
 
+#include <array>
+
 AmoebotParticle::AmoebotParticle(const Node& head, int globalTailDir,
                                  const int orientation, AmoebotSystem& system)
   : LocalParticle(head, globalTailDir, orientation),
-    system(system) {}
+    system(system),
+    systemIndex(0),
+    roundStamp(0),
+    arenaBlock(nullptr) {}
 
 AmoebotParticle::~AmoebotParticle() {}
 
@@ -45,7 +50,9 @@ void AmoebotParticle::expand(int label) {
   const int globalExpansionDir = localToGlobalDir(label);
   head = head.nodeInDir(globalExpansionDir);
   globalTailDir = (globalExpansionDir + 3) % 6;
-  system.particleMap[head] = this;
+  system.lattice.setParticleAt(head, this);
+  system.lattice.setExpandedHeadAt(head, true);
+  system.connectivity.nodeOccupied(head);
 
   system.registerMovement();
 }
@@ -66,12 +73,14 @@ void AmoebotParticle::push(int label) {
 
   head = handoverNode;
   globalTailDir = (globalExpansionDir + 3) % 6;
-  system.particleMap[handoverNode] = this;
+  system.lattice.setParticleAt(handoverNode, this);
 
   if (handoverNode == neighbor.head) {
     neighbor.head = neighbor.tail();
   }
   neighbor.globalTailDir = -1;
+  system.lattice.setExpandedHeadAt(neighbor.head, false);
+  system.lattice.setExpandedHeadAt(handoverNode, true);
 
   system.registerMovement(2);
   system.registerActivation(&neighbor);
@@ -87,7 +96,8 @@ void AmoebotParticle::contract(int label) {
 void AmoebotParticle::contractHead() {
   Q_ASSERT(isExpanded());
 
-  system.particleMap.erase(head);
+  system.lattice.clearParticleAt(head);
+  system.connectivity.nodeVacated(head);
   head = tail();
   globalTailDir = -1;
 
@@ -97,7 +107,9 @@ void AmoebotParticle::contractHead() {
 void AmoebotParticle::contractTail() {
   Q_ASSERT(isExpanded());
 
-  system.particleMap.erase(tail());
+  system.lattice.clearParticleAt(tail());
+  system.lattice.setExpandedHeadAt(head, false);
+  system.connectivity.nodeVacated(tail());
   globalTailDir = -1;
 
   system.registerMovement();
@@ -124,15 +136,38 @@ void AmoebotParticle::pull(int label) {
   globalTailDir = -1;
   neighbor.head = handoverNode;
   neighbor.globalTailDir = globalPullDir;
-  system.particleMap[handoverNode] = &neighbor;
+  system.lattice.setParticleAt(handoverNode, &neighbor);
+  system.lattice.setExpandedHeadAt(head, false);
+  system.lattice.setExpandedHeadAt(handoverNode, true);
 
   system.registerMovement(2);
   system.registerActivation(&neighbor);
 }
 
 bool AmoebotParticle::hasNbrAtLabel(int label) const {
-  const Node neighboringNode = nbrNodeReachedViaLabel(label);
-  return system.particleMap.find(neighboringNode) != system.particleMap.end();
+  return system.lattice.hasParticleAt(nbrNodeReachedViaLabel(label));
+}
+
+int AmoebotParticle::nbrLabelMask() const {
+  return labelMask(system.lattice.nbrMask(head),
+                   isExpanded() ? system.lattice.nbrMask(tail()) : 0);
+}
+
+int AmoebotParticle::expHeadLabelMask() const {
+  return labelMask(
+      system.lattice.expandedHeadNbrMask(head),
+      isExpanded() ? system.lattice.expandedHeadNbrMask(tail()) : 0);
+}
+
+int AmoebotParticle::numLabelsIn(int mask) {
+  Q_ASSERT(0 <= mask && mask < (1 << 10));
+
+  static const std::array<int, 32> bitCounts = {
+    {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+     1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5}
+  };
+
+  return bitCounts[mask & 31] + bitCounts[mask >> 5];
 }
 
 bool AmoebotParticle::hasHeadAtLabel(int label) {
@@ -154,14 +189,39 @@ bool AmoebotParticle::hasTailAtLabel(int label) {
 }
 
 bool AmoebotParticle::hasObjectAtLabel(int label) const {
-  const Node neighboringNode = nbrNodeReachedViaLabel(label);
-  return system.objectMap.find(neighboringNode) != system.objectMap.end();
+  return system.lattice.hasObjectAt(nbrNodeReachedViaLabel(label));
 }
 
 bool AmoebotParticle::hasObjectNbr() const {
   return labelOfFirstObjectNbr() != -1;
 }
 
+int AmoebotParticle::labelMask(const unsigned int headMask,
+                               const unsigned int tailMask) const {
+  // Local direction i is global direction (orientation + i) % 6, so local
+  // masks are the global ones rotated by the orientation.
+  auto toLocal = [this](const unsigned int globalMask) {
+    return ((globalMask >> orientation) | (globalMask << (6 - orientation))) &
+           63;
+  };
+
+  if (isContracted()) {
+    return toLocal(headMask);  // Labels coincide with local directions.
+  }
+
+  const unsigned int localHeadMask = toLocal(headMask);
+  const unsigned int localTailMask = toLocal(tailMask);
+  int mask = 0;
+  for (const int label : headLabels()) {
+    mask |= ((localHeadMask >> labelToDir(label)) & 1) << label;
+  }
+  for (const int label : tailLabels()) {
+    mask |= ((localTailMask >> labelToDir(label)) & 1) << label;
+  }
+
+  return mask;
+}
+
 int AmoebotParticle::labelOfFirstObjectNbr(int startLabel) const {
   const int labelLimit = isContracted() ? 6 : 10;
   for (int labelOffset = 0; labelOffset < labelLimit; labelOffset++) {
@@ -173,7 +233,3 @@ int AmoebotParticle::labelOfFirstObjectNbr(int startLabel) const {
 
   return -1;
 }
-
-void AmoebotParticle::putToken(std::shared_ptr<Token> token) {
-  tokens.push_back(token);
-}
@@ -13,17 +13,19 @@
 #ifndef AMOEBOTSIM_CORE_AMOEBOTPARTICLE_H_
 #define AMOEBOTSIM_CORE_AMOEBOTPARTICLE_H_
 
-#include <deque>
 #include <functional>
-#include <map>
 #include <memory>
+#include <utility>
 
 #include "core/amoebotsystem.h"
 #include "core/localparticle.h"
 #include "core/node.h"
-#include "helper/randomnumbergenerator.h"
+#include "core/tokenstore.h"
+
+class AmoebotParticle : public LocalParticle {
+  friend class AmoebotSystem;
+  friend class ClusterAnalysis;
 
-class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
  public:
   // Constructs a new particle with a node position for its head, a global
   // compass direction from its head to its tail (-1 if contracted), an offset
@@ -79,7 +81,9 @@ class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
 
   // Gets a reference to the neighboring particle incident to the specified port
   // label. Crashes if no such particle exists at this label; consider using
-  // hasNbrAtLabel() first if unsure.
+  // hasNbrAtLabel() first if unsure. The neighbor must be of the given type,
+  // which is only checked in debug builds; systems guarantee this by admitting
+  // a single particle type (see core/typedamoebotsystem.h).
   template<class ParticleType>
   ParticleType& nbrAtLabel(int label) const;
 
@@ -90,6 +94,18 @@ class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
   bool hasHeadAtLabel(int label);
   bool hasTailAtLabel(int label);
 
+  // Functions returning this particle's whole neighborhood at once as a bit
+  // mask over its port labels (6 bits if contracted, 10 if expanded).
+  // nbrLabelMask has bit i set iff hasNbrAtLabel(i), and expHeadLabelMask has
+  // bit i set iff the neighbor at label i is the head of an expanded particle.
+  // These read the masks the lattice maintains on every movement, costing one
+  // lookup per occupied node instead of one probe per label, so local rules
+  // can be written as a mask read followed by bit operations or table lookups.
+  // numLabelsIn returns the number of labels in a mask.
+  int nbrLabelMask() const;
+  int expHeadLabelMask() const;
+  static int numLabelsIn(int mask);
+
   // Function for checking the existence of a neighboring object
   bool hasObjectAtLabel(int label) const;
   bool hasObjectNbr() const;
@@ -120,7 +136,13 @@ class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
   // returned reference from this particle's collection. Note that peekAtToken
   // and takeToken both fail when no token of the given type exists in the
   // collection; consider using hasToken() first if unsure.
-  void putToken(std::shared_ptr<Token> token);
+  //
+  // Tokens are kept in one bucket per token type (see core/tokenstore.h), so
+  // these functions only cost as much as the number of different token types
+  // this particle holds, not the number of tokens. Among several tokens of the
+  // specified type, the one put first is returned.
+  template<class TokenType>
+  void putToken(std::shared_ptr<TokenType> token);
   template<class TokenType>
   std::shared_ptr<TokenType> peekAtToken() const;
   template<class TokenType>
@@ -152,20 +174,75 @@ class AmoebotParticle : public LocalParticle, public RandomNumberGenerator {
   bool hasToken(std::function<bool(const std::shared_ptr<TokenType>)>
                 propertyCheck) const;
 
+  // Constructs a token of the given type in this particle's system's token
+  // pool, which is cheaper than std::make_shared; see
+  // AmoebotSystem::makeToken.
+  template<class TokenType, class... Args>
+  std::shared_ptr<TokenType> makeToken(Args&&... args) const;
+
+  // Functions for drawing random values from the system's generator stream; see
+  // helper/randomnumbergenerator.h. Particle constructors must draw through
+  // their system argument instead, as these are not usable until the particle
+  // has been constructed.
+  int randInt(const int from, const int toNotIncluding) const;
+  int randDir() const;
+  float randFloat(const float from, const float toNotIncluding) const;
+  double randDouble(const double from, const double toNotIncluding) const;
+  bool randBool(const double trueProb = 0.5) const;
+
   AmoebotSystem& system;
 
  private:
-  std::deque<std::shared_ptr<Token>> tokens;
+  // Converts the given global direction masks of this particle's head and tail
+  // into a mask over its labels.
+  int labelMask(const unsigned int headMask, const unsigned int tailMask) const;
+
+  TokenStore<Token> tokens;
+
+  // This particle's position in its system's particle list, maintained by the
+  // system so that removal does not have to search for it.
+  unsigned int systemIndex;
+
+  // The system round epoch in which this particle was last activated; see
+  // AmoebotSystem::registerActivation.
+  unsigned int roundStamp;
+
+  // The block of its system's particle arena holding this particle if it was
+  // created by AmoebotSystem::newParticle, and nullptr if it was created with
+  // new. The block need not start at this AmoebotParticle base.
+  void* arenaBlock;
 };
 
+inline int AmoebotParticle::randInt(const int from,
+                                    const int toNotIncluding) const {
+  return system.randInt(from, toNotIncluding);
+}
+
+inline int AmoebotParticle::randDir() const {
+  return system.randDir();
+}
+
+inline float AmoebotParticle::randFloat(const float from,
+                                        const float toNotIncluding) const {
+  return system.randFloat(from, toNotIncluding);
+}
+
+inline double AmoebotParticle::randDouble(const double from,
+                                          const double toNotIncluding) const {
+  return system.randDouble(from, toNotIncluding);
+}
+
+inline bool AmoebotParticle::randBool(const double trueProb) const {
+  return system.randBool(trueProb);
+}
+
 template<class ParticleType>
 ParticleType& AmoebotParticle::nbrAtLabel(int label) const {
-  Node nbrNode = nbrNodeReachedViaLabel(label);
-  auto it = system.particleMap.find(nbrNode);
-  Q_ASSERT(it != system.particleMap.end() &&
-           dynamic_cast<ParticleType*>(it->second) != nullptr);
+  AmoebotParticle* nbr =
+      system.lattice.particleAt(nbrNodeReachedViaLabel(label));
+  Q_ASSERT(nbr != nullptr && dynamic_cast<ParticleType*>(nbr) != nullptr);
 
-  return dynamic_cast<ParticleType&>(*(it->second));
+  return static_cast<ParticleType&>(*nbr);
 }
 
 template<class ParticleType>
@@ -173,9 +250,10 @@ int AmoebotParticle::labelOfFirstNbrWithProperty(
     std::function<bool(const ParticleType&)> propertyCheck,
     int startLabel) const {
   const int labelLimit = isContracted() ? 6 : 10;
+  const int nbrs = nbrLabelMask();
   for (int labelOffset = 0; labelOffset < labelLimit; labelOffset++) {
     const int label = (startLabel + labelOffset) % labelLimit;
-    if (hasNbrAtLabel(label)) {
+    if ((nbrs >> label) & 1) {
       const ParticleType& particle = nbrAtLabel<ParticleType>(label);
       if (propertyCheck(particle)) {
         return label;
@@ -186,110 +264,66 @@ int AmoebotParticle::labelOfFirstNbrWithProperty(
   return -1;
 }
 
+template<class TokenType, class... Args>
+std::shared_ptr<TokenType> AmoebotParticle::makeToken(Args&&... args) const {
+  return system.makeToken<TokenType>(std::forward<Args>(args)...);
+}
+
+template<class TokenType>
+void AmoebotParticle::putToken(std::shared_ptr<TokenType> token) {
+  tokens.put(std::move(token));
+}
+
 template<class TokenType>
 std::shared_ptr<TokenType> AmoebotParticle::peekAtToken() const {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr) {
-      return token;
-    }
-  }
-  Q_ASSERT(false);
+  std::shared_ptr<TokenType> token = tokens.peek<TokenType>();
+  Q_ASSERT(token != nullptr);
+  return token;
 }
 
 template<class TokenType>
 std::shared_ptr<TokenType> AmoebotParticle::peekAtToken(
     std::function<bool(const std::shared_ptr<TokenType>)> propertyCheck) const {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr && propertyCheck(token)) {
-      return token;
-    }
-  }
-  Q_ASSERT(false);
+  std::shared_ptr<TokenType> token = tokens.peek<TokenType>(propertyCheck);
+  Q_ASSERT(token != nullptr);
+  return token;
 }
 
 template<class TokenType>
 std::shared_ptr<TokenType> AmoebotParticle::takeToken() {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr) {
-      std::swap(tokens[0], tokens[i]);
-      tokens.pop_front();
-      return token;
-    }
-  }
-  Q_ASSERT(false);
+  std::shared_ptr<TokenType> token = tokens.take<TokenType>();
+  Q_ASSERT(token != nullptr);
+  return token;
 }
 
 template<class TokenType>
 std::shared_ptr<TokenType> AmoebotParticle::takeToken(
     std::function<bool(const std::shared_ptr<TokenType>)> propertyCheck) {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr && propertyCheck(token)) {
-      std::swap(tokens[0], tokens[i]);
-      tokens.pop_front();
-      return token;
-    }
-  }
-  Q_ASSERT(false);
+  std::shared_ptr<TokenType> token = tokens.take<TokenType>(propertyCheck);
+  Q_ASSERT(token != nullptr);
+  return token;
 }
 
 template<class TokenType>
 int AmoebotParticle::countTokens() const {
-  int count = 0;
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr) {
-      count++;
-    }
-  }
-  return count;
+  return tokens.count<TokenType>();
 }
 
 template<class TokenType>
 int AmoebotParticle::countTokens(
     std::function<bool(const std::shared_ptr<TokenType>)> propertyCheck) const {
-  int count = 0;
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr && propertyCheck(token)) {
-      count++;
-    }
-  }
-  return count;
+  return tokens.count<TokenType>(propertyCheck);
 }
 
 template<class TokenType>
 bool AmoebotParticle::hasToken() const {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr) {
-      return true;
-    }
-  }
-  return false;
+  return tokens.count<TokenType>() > 0;
 }
 
 template<class TokenType>
 bool AmoebotParticle::hasToken(
     std::function<bool(const std::shared_ptr<TokenType>)> propertyCheck) const {
-  for (unsigned int i = 0; i < tokens.size(); i++) {
-    std::shared_ptr<TokenType> token =
-        std::dynamic_pointer_cast<TokenType>(tokens[i]);
-    if (token != nullptr && propertyCheck(token)) {
-      return true;
-    }
-  }
-  return false;
+  return tokens.peek<TokenType>(propertyCheck) != nullptr;
 }
 
 #endif  // AMOEBOTSIM_CORE_AMOEBOTPARTICLE_H_
@@ -4,20 +4,21 @@
 
 #include "core/amoebotsystem.h"
 
-#include <QDateTime>
 #include <QtGlobal>
 
 #include "core/amoebotparticle.h"
 
-AmoebotSystem::AmoebotSystem() {
-  _counts.push_back(new Count("# Rounds"));
-  _counts.push_back(new Count("# Activations"));
-  _counts.push_back(new Count("# Moves"));
-}
+AmoebotSystem::AmoebotSystem()
+  : connectivity(lattice),
+    roundEpoch(1),
+    numActivatedThisRound(0),
+    roundCount(addCount("# Rounds")),
+    activationCount(addCount("# Activations")),
+    moveCount(addCount("# Moves")) {}
 
 AmoebotSystem::~AmoebotSystem() {
   for (auto p : particles) {
-    delete p;
+    deleteParticle(p);
   }
   particles.clear();
 
@@ -44,10 +45,10 @@ void AmoebotSystem::activate() {
 }
 
 void AmoebotSystem::activateParticleAt(Node node) {
-  auto it = particleMap.find(node);
-  if (it != particleMap.end()) {
-    registerActivation(it->second);
-    it->second->activate();
+  AmoebotParticle* particle = lattice.particleAt(node);
+  if (particle != nullptr) {
+    registerActivation(particle);
+    particle->activate();
   }
 }
 
@@ -68,52 +69,70 @@ const std::deque<Object*>& AmoebotSystem::getObjects() const {
 }
 
 void AmoebotSystem::insert(AmoebotParticle* particle) {
-  Q_ASSERT(particleMap.find(particle->head) == particleMap.end());
-  Q_ASSERT(objectMap.find(particle->head) == objectMap.end());
-  Q_ASSERT(!particle->isExpanded() ||
-           particleMap.find(particle->tail()) == particleMap.end());
-
+  Q_ASSERT(particle->arenaBlock == nullptr ||
+           static_cast<ParticleHeader*>(particle->arenaBlock)->owner == this);
+  Q_ASSERT(!lattice.hasParticleAt(particle->head));
+  Q_ASSERT(!lattice.hasObjectAt(particle->head));
+  Q_ASSERT(!particle->isExpanded() || !lattice.hasParticleAt(particle->tail()));
+
+  particle->systemIndex = particles.size();
+  particle->roundStamp = roundEpoch - 1;
   particles.push_back(particle);
-  particleMap[particle->head] = particle;
+  lattice.setParticleAt(particle->head, particle);
+  connectivity.nodeOccupied(particle->head);
   if (particle->isExpanded()) {
-    particleMap[particle->tail()] = particle;
+    lattice.setParticleAt(particle->tail(), particle);
+    lattice.setExpandedHeadAt(particle->head, true);
+    connectivity.nodeOccupied(particle->tail());
   }
 }
 
 void AmoebotSystem::insert(Object* object) {
-  Q_ASSERT(objectMap.find(object->_node) == objectMap.end());
-  Q_ASSERT(particleMap.find(object->_node) == particleMap.end());
+  Q_ASSERT(!lattice.hasObjectAt(object->_node));
+  Q_ASSERT(!lattice.hasParticleAt(object->_node));
 
   objects.push_back(object);
-  objectMap[object->_node] = object;
+  lattice.setObjectAt(object->_node);
 }
 
 void AmoebotSystem::remove(AmoebotParticle* particle) {
-  particles.erase(std::remove(particles.begin(), particles.end(), particle),
-                  particles.end());
-  auto it = particleMap.begin();
-  while (it != particleMap.end()) {
-    if (it->second == particle) {
-      it = particleMap.erase(it);
-    } else {
-      it++;
-    }
+  Q_ASSERT(particle->systemIndex < particles.size() &&
+           particles[particle->systemIndex] == particle);
+
+  // Move the last particle into the removed particle's slot so the list stays
+  // contiguous without shifting every particle after it.
+  AmoebotParticle* last = particles.back();
+  particles[particle->systemIndex] = last;
+  last->systemIndex = particle->systemIndex;
+  particles.pop_back();
+
+  lattice.clearParticleAt(particle->head);
+  connectivity.nodeVacated(particle->head);
+  if (particle->isExpanded()) {
+    lattice.clearParticleAt(particle->tail());
+    connectivity.nodeVacated(particle->tail());
+  }
+  if (particle->roundStamp == roundEpoch) {
+    --numActivatedThisRound;
   }
-  activatedParticles.erase(particle);
 
-  delete particle;
+  deleteParticle(particle);
 }
 
 void AmoebotSystem::registerMovement(unsigned int numMoves) {
-  getCount("# Moves").record(numMoves);
+  moveCount.record(numMoves);
 }
 
 void AmoebotSystem::registerActivation(AmoebotParticle* particle) {
-  getCount("# Activations").record();
-  activatedParticles.insert(particle);
-  if (activatedParticles.size() == particles.size()) {
+  activationCount.record();
+  if (particle->roundStamp != roundEpoch) {
+    particle->roundStamp = roundEpoch;
+    ++numActivatedThisRound;
+  }
+  if (numActivatedThisRound == particles.size()) {
     registerRound();
-    activatedParticles.clear();
+    ++roundEpoch;
+    numActivatedThisRound = 0;
   }
 }
 
@@ -122,11 +141,11 @@ void AmoebotSystem::registerRound() {
     c->_history.push_back(c->_value);
   }
   for (const auto& m : _measures) {
-    if (getCount("# Rounds")._value % m->_freq == 0) {
+    if (roundCount._value % m->_freq == 0) {
       m->_history.push_back(m->calculate());
     }
   }
-  getCount("# Rounds").record();
+  roundCount.record();
 }
 
 const std::vector<Count*>& AmoebotSystem::getCounts() const {
@@ -137,61 +156,41 @@ const std::vector<Measure*>& AmoebotSystem::getMeasures() const {
   return _measures;
 }
 
-Count& AmoebotSystem::getCount(QString name) const {
-  for (const auto& c : _counts) {
-    if (QString::compare(c->_name, name) == 0) {
-      return *c;
-    }
-  }
-  Q_ASSERT(false);  // Requested count does not exist.
+Count& AmoebotSystem::addCount(const QString name) {
+  _counts.push_back(new Count(name));
+  return *_counts.back();
 }
 
-Measure& AmoebotSystem::getMeasure(QString name) const {
-  for (const auto& m : _measures) {
-    if (QString::compare(m->_name, name) == 0) {
-      return *m;
-    }
+uint64_t AmoebotSystem::getSeed() const {
+  return RandomNumberGenerator::getSeed();
+}
+
+void AmoebotSystem::deleteParticle(AmoebotParticle* particle) {
+  void* block = particle->arenaBlock;
+  if (block == nullptr) {
+    delete particle;
+  } else {
+    const std::size_t blockSize =
+        static_cast<ParticleHeader*>(block)->blockSize;
+    particle->~AmoebotParticle();
+    particleArena.deallocate(block, blockSize);
   }
-  Q_ASSERT(false);  // Requested measure does not exist.
 }
 
+void AmoebotSystem::setArenaBlock(AmoebotParticle* particle, void* block) {
+  particle->arenaBlock = block;
+}
 
-const QString AmoebotSystem::metricsAsJSON() const {
-  QString json = "{\"title\" : \"AmoebotSim Metrics JSON\", ";
-  json += "\"datetime\" : \"" +
-          QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") + "\", ";
-  json += "\"algorithm\" : \"???\", ";
-  json += "\"counts\" : [";
-  for (const auto& c : _counts) {
-    json += "{\"name\" : \"" + c->_name + "\", ";
-    json += "\"history\" : [";
-    for (auto val : c->_history) {
-      json += QString::number(val) += ", ";
-    }
-    if (!c->_history.empty()) {
-      json.chop(2);  // Remove the last ", ".
-    }
-    json += "]}, ";
-  }
-  if (!_counts.empty()) {
-    json.chop(2);  // Remove the last ", ".
-  }
-  json += "], \"measures\" : [";
-  for (const auto& m : _measures) {
-    json += "{\"name\" : \"" + m->_name + "\", ";
-    json += "\"frequency\" : " + QString::number(m->_freq) + ", ";
-    json += "\"history\" : [";
-    for (auto val : m->_history) {
-      json += QString::number(val) += ", ";
-    }
-    if (!m->_history.empty()) {
-      json.chop(2);  // Remove the last ", ".
-    }
-    json += "]}, ";
-  }
-  if (!_measures.empty()) {
-    json.chop(2);  // Remove the last ", ".
+bool AmoebotSystem::isConnected() const {
+  if (!connectivity.isKnown()) {
+    connectivity.setConnected(particles.empty() ||
+                              System::isConnected(particles));
   }
-  json += "]}";
-  return json;
+
+  return connectivity.isConnected();
+}
+
+const ClusterAnalysis& AmoebotSystem::clusters() const {
+  clusterAnalysis.analyze(particles, lattice);
+  return clusterAnalysis;
 }
@@ -8,15 +8,25 @@
 #ifndef AMOEBOTSIM_CORE_AMOEBOTSYSTEM_H_
 #define AMOEBOTSIM_CORE_AMOEBOTSYSTEM_H_
 
+#include <cstddef>
 #include <deque>
 #include <map>
-#include <set>
+#include <memory>
+#include <new>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 #include <QString>
 
+#include "core/clusteranalysis.h"
+#include "core/connectivitymonitor.h"
+#include "core/lattice.h"
+#include "core/memorypool.h"
 #include "core/metric.h"
 #include "core/object.h"
+#include "core/statecounter.h"
 #include "core/system.h"
 #include "helper/randomnumbergenerator.h"
 
@@ -28,7 +38,9 @@ class AmoebotSystem : public System, public RandomNumberGenerator {
 
  public:
   // Constructs a new particle system with fresh round, activation, and movement
-  // counts.
+  // counts. Its random number generator is seeded with the calling thread's
+  // default seed if one is set and from entropy otherwise; see
+  // RandomNumberGenerator::setDefaultSeed.
   AmoebotSystem();
 
   // Deletes the particles, objects, and metrics in this system before
@@ -53,13 +65,31 @@ class AmoebotSystem : public System, public RandomNumberGenerator {
   // Returns a reference to the object list.
   virtual const std::deque<Object*>& getObjects() const final;
 
+  // Constructs a particle of the given type from the given constructor
+  // arguments in this system's particle arena and returns it. Particles
+  // inserted into the system should be created this way instead of with new,
+  // which still works but allocates each particle on the global heap; either
+  // way, the system destroys them when they are removed or the system is
+  // deleted.
+  template<class ParticleType, class... Args>
+  ParticleType* newParticle(Args&&... args);
+
+  // Constructs a token of the given type from the given constructor arguments,
+  // placing it and its reference count in a single block of this system's
+  // token pool. Tokens must not outlive the system that made them.
+  template<class TokenType, class... Args>
+  std::shared_ptr<TokenType> makeToken(Args&&... args);
+
   // Inserts a particle or an object, respectively, into the system. A particle
   // can be contracted or expanded. Fails if the respective node(s) are already
-  // occupied.
+  // occupied. A particle created by newParticle must come from this system's.
   void insert(AmoebotParticle* particle);
   void insert(Object* object);
 
-  // Removes the specified particle from the system.
+  // Removes the specified particle from the system in constant time and
+  // destroys it. The last particle in the system takes over the removed
+  // particle's index, so indices passed to at() are not stable across
+  // removals.
   void remove(AmoebotParticle* particle);
 
   // Functions for logging system progress. registerMovement logs the given
@@ -67,33 +97,137 @@ class AmoebotSystem : public System, public RandomNumberGenerator {
   // given particle has been activated. When all particles have been activated
   // at least once, this resets its logging and triggers registerRound(), which
   // commits all counts and measures to their histories and increments the
-  // number of completed asynchronous rounds by one.
+  // number of completed asynchronous rounds by one. Activations are tracked by
+  // stamping each particle with the current round epoch, so starting a new
+  // round is a single increment rather than clearing a set.
   void registerMovement(unsigned int numMoves = 1);
   void registerActivation(AmoebotParticle* particle);
   void registerRound();
 
   // Various access functions for metrics (counts and measures). getCounts
   // (resp., getMeasures) returns a reference to the count (resp., measure)
-  // list. getCount (resp., getMeasure) returns a reference to the named count
-  // (resp., measure). These functions crash if the requested count/measure is
-  // not found!
+  // list. The name lookups System::getCount and System::getMeasure are linear
+  // in the number of metrics and are meant for the GUI and scripting
+  // interfaces; algorithms should record through the handle returned by
+  // addCount instead.
   const std::vector<Count*>& getCounts() const final;
   const std::vector<Measure*>& getMeasures() const final;
-  Count& getCount(QString name) const final;
-  Measure& getMeasure(QString name) const final;
 
-  // Formats the count and measure histories as a JSON string. The structure of
-  // this JSON string can be found in the Usage documentation.
-  const QString metricsAsJSON() const final;
+  // Returns the seed of this system's random number generator stream, which
+  // its particles also draw from.
+  uint64_t getSeed() const final;
+
+  // Checks whether the nodes occupied by this system's particles form one
+  // connected component. The answer is maintained incrementally as particles
+  // move (see core/connectivitymonitor.h), so after the first query this
+  // typically costs constant time per movement instead of a search of the
+  // whole system per query.
+  bool isConnected() const;
+
+  // Partitions this system's particles into clusters of neighboring particles
+  // (see core/clusteranalysis.h) and returns the result, which is valid until
+  // the next call. The analysis reuses its memory from call to call.
+  const ClusterAnalysis& clusters() const;
+
+  // Returns this system's population counter for particle states of the given
+  // enum type, creating it on first use. Particles register their state with
+  // it by storing the state in a CountedState, after which termination
+  // predicates can count the particles in any state in constant time.
+  template<class State>
+  StateCounter<State>& stateCounter();
+  template<class State>
+  const StateCounter<State>& stateCounter() const;
 
  protected:
+  // Creates a new count with the given name, appends it to this system's count
+  // list, and returns a handle to it. Recording through the handle avoids the
+  // name lookup performed by getCount.
+  Count& addCount(const QString name);
+
   std::vector<AmoebotParticle*> particles;
-  std::map<Node, AmoebotParticle*> particleMap;
-  std::set<AmoebotParticle*> activatedParticles;
+  Lattice<AmoebotParticle> lattice;
+  mutable ConnectivityMonitor<AmoebotParticle> connectivity;
+  mutable ClusterAnalysis clusterAnalysis;
+  unsigned int roundEpoch;
+  unsigned int numActivatedThisRound;
   std::deque<Object*> objects;
-  std::map<Node, Object*> objectMap;
   std::vector<Count*> _counts;
   std::vector<Measure*> _measures;
+
+  // Handles to the counts every system maintains.
+  Count& roundCount;
+  Count& activationCount;
+  Count& moveCount;
+
+ private:
+  // Destructs the given particle and returns its memory to the particle arena
+  // if it was created by newParticle, and deletes it otherwise.
+  void deleteParticle(AmoebotParticle* particle);
+
+  // Records the arena block holding the given particle; used by newParticle,
+  // where AmoebotParticle is incomplete.
+  static void setArenaBlock(AmoebotParticle* particle, void* block);
+
+  // Each particle is preceded in the arena by a header recording the size of
+  // its block, since particles are destroyed through base class pointers that
+  // don't know it, and the system whose arena the block belongs to.
+  struct ParticleHeader {
+    std::size_t blockSize;
+    const AmoebotSystem* owner;
+  };
+  static constexpr std::size_t particleHeaderSize = MemoryPool::alignment;
+  static_assert(sizeof(ParticleHeader) <= particleHeaderSize,
+                "Particle header does not fit in front of the particle.");
+
+  // Particles and tokens are allocated from pools owned by the system. The
+  // destructor destructs all particles (and with them their tokens) before
+  // these are destroyed, releasing all of their memory at once.
+  MemoryPool particleArena;
+  MemoryPool tokenPool;
+
+  // Keyed by state type. The destructor deletes all particles before these
+  // counters are destroyed, so every CountedState outlives its counter's use.
+  // Mutable since const queries create missing (empty) counters.
+  mutable std::map<std::type_index, std::unique_ptr<StateCounterBase>>
+      stateCounters;
 };
 
+template<class ParticleType, class... Args>
+ParticleType* AmoebotSystem::newParticle(Args&&... args) {
+  static_assert(alignof(ParticleType) <= MemoryPool::alignment,
+                "Particle type is over-aligned for the particle arena.");
+
+  const std::size_t blockSize = particleHeaderSize + sizeof(ParticleType);
+  char* block = static_cast<char*>(particleArena.allocate(blockSize));
+  new (block) ParticleHeader{blockSize, this};
+
+  ParticleType* particle = new (block + particleHeaderSize)
+      ParticleType(std::forward<Args>(args)...);
+  setArenaBlock(particle, block);
+
+  return particle;
+}
+
+template<class TokenType, class... Args>
+std::shared_ptr<TokenType> AmoebotSystem::makeToken(Args&&... args) {
+  return std::allocate_shared<TokenType>(PoolAllocator<TokenType>(tokenPool),
+                                         std::forward<Args>(args)...);
+}
+
+template<class State>
+StateCounter<State>& AmoebotSystem::stateCounter() {
+  return const_cast<StateCounter<State>&>(
+      static_cast<const AmoebotSystem*>(this)->stateCounter<State>());
+}
+
+template<class State>
+const StateCounter<State>& AmoebotSystem::stateCounter() const {
+  auto& counter = stateCounters[std::type_index(typeid(State))];
+  if (counter == nullptr) {
+    counter.reset(new StateCounter<State>());
+  }
+
+  return static_cast<const StateCounter<State>&>(*counter);
+}
+
 #endif  // AMOEBOTSIM_CORE_AMOEBOTSYSTEM_H_
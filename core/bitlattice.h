@@ -0,0 +1,144 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a bit-packed occupancy store for the triangular lattice, for
+// specialized engines simulating far more particles than the object-per-
+// particle model can (see alg/compressionbitboard.h). Instead of a cell per
+// node, it keeps NumPlanes independent bits per node (e.g., "occupied" and
+// "expanded head"). Like Lattice, it is cut into sparsely allocated square
+// tiles (see core/tiledirectory.h); each tile row of a plane is a single
+// 64-bit word, so a tile of 64^2 nodes costs only 512 bytes per plane.
+//
+// gather reads the bits of several nodes around an origin at once, resolving
+// the origin's tile only once whenever the nodes lie inside it.
+
+#ifndef AMOEBOTSIM_CORE_BITLATTICE_H_
+#define AMOEBOTSIM_CORE_BITLATTICE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <QtGlobal>
+
+#include "core/node.h"
+#include "core/tiledirectory.h"
+
+template<int NumPlanes>
+class BitLattice {
+ public:
+  // Functions for reading and writing a node's bit in the given plane. set and
+  // reset allocate the tile containing the node if necessary; test never does,
+  // as nodes in unallocated tiles have all their bits cleared.
+  bool test(int plane, const Node& node) const;
+  void set(int plane, const Node& node);
+  void reset(int plane, const Node& node);
+
+  // Returns a mask whose bit i is the given plane's bit of the node at origin +
+  // offsets[i], where offsets are (x, y) displacements that may not exceed
+  // maxGatherOffset in either coordinate.
+  template<std::size_t N>
+  unsigned int gather(int plane, const Node& origin,
+                      const std::array<Node, N>& offsets) const;
+
+  // Releases all tiles, clearing every bit.
+  void clear();
+
+  // Returns the number of tiles currently allocated.
+  unsigned int numTiles() const;
+
+  static constexpr int tileBits = 6;
+  static constexpr int tileSize = 1 << tileBits;
+  static constexpr int tileMask = tileSize - 1;
+  static constexpr int maxGatherOffset = 2;
+
+ private:
+  // Row y holds, for each plane, the bits of the tile's nodes with that in-tile
+  // y-coordinate, indexed by in-tile x-coordinate. The planes of a row are
+  // interleaved, so reading the same nodes in several planes touches the same
+  // cache lines.
+  using Tile = std::array<std::array<uint64_t, NumPlanes>, tileSize>;
+
+  static int tileCoord(int coord);
+
+  TileDirectory<Tile> _tiles;
+};
+
+template<int NumPlanes>
+inline bool BitLattice<NumPlanes>::test(int plane, const Node& node) const {
+  Q_ASSERT(0 <= plane && plane < NumPlanes);
+
+  const Tile* tile = _tiles.find(tileCoord(node.x), tileCoord(node.y));
+  return tile != nullptr &&
+         (((*tile)[node.y & tileMask][plane] >> (node.x & tileMask)) & 1);
+}
+
+template<int NumPlanes>
+inline void BitLattice<NumPlanes>::set(int plane, const Node& node) {
+  Q_ASSERT(0 <= plane && plane < NumPlanes);
+
+  Tile& tile = _tiles.at(tileCoord(node.x), tileCoord(node.y));
+  tile[node.y & tileMask][plane] |= uint64_t(1) << (node.x & tileMask);
+}
+
+template<int NumPlanes>
+inline void BitLattice<NumPlanes>::reset(int plane, const Node& node) {
+  Q_ASSERT(0 <= plane && plane < NumPlanes);
+
+  Tile* tile = _tiles.find(tileCoord(node.x), tileCoord(node.y));
+  if (tile != nullptr) {
+    (*tile)[node.y & tileMask][plane] &= ~(uint64_t(1) << (node.x & tileMask));
+  }
+}
+
+template<int NumPlanes>
+template<std::size_t N>
+inline unsigned int BitLattice<NumPlanes>::gather(
+    int plane, const Node& origin, const std::array<Node, N>& offsets) const {
+  static_assert(N <= 32, "Cannot gather more nodes than bits in a mask.");
+  Q_ASSERT(0 <= plane && plane < NumPlanes);
+
+  unsigned int mask = 0;
+  const int x = origin.x & tileMask;
+  const int y = origin.y & tileMask;
+  if (maxGatherOffset <= x && x < tileSize - maxGatherOffset &&
+      maxGatherOffset <= y && y < tileSize - maxGatherOffset) {
+    // All nodes lie in the origin's tile.
+    const Tile* tile = _tiles.find(tileCoord(origin.x), tileCoord(origin.y));
+    if (tile != nullptr) {
+      for (std::size_t i = 0; i < N; ++i) {
+        Q_ASSERT(qAbs(offsets[i].x) <= maxGatherOffset &&
+                 qAbs(offsets[i].y) <= maxGatherOffset);
+        const uint64_t row = (*tile)[y + offsets[i].y][plane];
+        mask |= ((row >> (x + offsets[i].x)) & 1) << i;
+      }
+    }
+  } else {
+    for (std::size_t i = 0; i < N; ++i) {
+      const Node node(origin.x + offsets[i].x, origin.y + offsets[i].y);
+      mask |= static_cast<unsigned int>(test(plane, node)) << i;
+    }
+  }
+
+  return mask;
+}
+
+template<int NumPlanes>
+void BitLattice<NumPlanes>::clear() {
+  _tiles.clear();
+}
+
+template<int NumPlanes>
+unsigned int BitLattice<NumPlanes>::numTiles() const {
+  return _tiles.numTiles();
+}
+
+template<int NumPlanes>
+inline int BitLattice<NumPlanes>::tileCoord(int coord) {
+  // Arithmetic shift rounds toward negative infinity, as required for nodes
+  // with negative coordinates.
+  return coord >> tileBits;
+}
+
+#endif  // AMOEBOTSIM_CORE_BITLATTICE_H_
@@ -0,0 +1,98 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/clusteranalysis.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include <QtGlobal>
+
+#include "core/amoebotparticle.h"
+
+void ClusterAnalysis::analyze(const std::vector<AmoebotParticle*>& particles,
+                              const Lattice<AmoebotParticle>& lattice) {
+  const int numParticles = particles.size();
+  _parent.resize(numParticles);
+  std::iota(_parent.begin(), _parent.end(), 0);
+  _treeSize.assign(numParticles, 1);
+
+  for (int i = 0; i < numParticles; ++i) {
+    const AmoebotParticle* p = particles[i];
+    Q_ASSERT(p->systemIndex == static_cast<unsigned int>(i));
+    for (int k = 0; k < (p->isExpanded() ? 2 : 1); ++k) {
+      const Node node = (k == 0) ? p->head : p->tail();
+      const unsigned int mask = lattice.nbrMask(node);
+      for (int dir = 0; dir < 6; ++dir) {
+        if (mask & (1u << dir)) {
+          // Each pair of neighbors is seen from both sides; join it once.
+          const int j = lattice.particleAt(node.nodeInDir(dir))->systemIndex;
+          if (i < j) {
+            unite(i, j);
+          }
+        }
+      }
+    }
+  }
+
+  _rootCluster.assign(numParticles, -1);
+  _clusterOf.resize(numParticles);
+  _clusterSizes.clear();
+  for (int i = 0; i < numParticles; ++i) {
+    const int root = find(i);
+    if (_rootCluster[root] == -1) {
+      _rootCluster[root] = _clusterSizes.size();
+      _clusterSizes.push_back(0);
+    }
+    _clusterOf[i] = _rootCluster[root];
+    ++_clusterSizes[_clusterOf[i]];
+  }
+
+  _largestClusterSize = _clusterSizes.empty()
+      ? 0 : *std::max_element(_clusterSizes.begin(), _clusterSizes.end());
+}
+
+int ClusterAnalysis::numClusters() const {
+  return _clusterSizes.size();
+}
+
+const std::vector<int>& ClusterAnalysis::clusterSizes() const {
+  return _clusterSizes;
+}
+
+int ClusterAnalysis::clusterOf(int i) const {
+  Q_ASSERT(0 <= i && i < static_cast<int>(_clusterOf.size()));
+  return _clusterOf[i];
+}
+
+int ClusterAnalysis::largestClusterSize() const {
+  return _largestClusterSize;
+}
+
+double ClusterAnalysis::largestClusterFraction() const {
+  return _clusterOf.empty()
+      ? 0.0 : static_cast<double>(_largestClusterSize) / _clusterOf.size();
+}
+
+int ClusterAnalysis::find(int i) {
+  while (_parent[i] != i) {
+    _parent[i] = _parent[_parent[i]];
+    i = _parent[i];
+  }
+
+  return i;
+}
+
+void ClusterAnalysis::unite(int i, int j) {
+  i = find(i);
+  j = find(j);
+  if (i != j) {
+    if (_treeSize[i] < _treeSize[j]) {
+      std::swap(i, j);
+    }
+    _parent[j] = i;
+    _treeSize[i] += _treeSize[j];
+  }
+}
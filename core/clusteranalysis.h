@@ -0,0 +1,57 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines the partition of a system's particles into clusters, i.e., the
+// connected components of the graph in which two particles are adjacent if
+// they occupy neighboring nodes. Clusters are found with union-find over the
+// particles' positions in their system's particle list: each particle is
+// joined with the particles around its head and tail, which are read off the
+// lattice's neighborhood masks (see core/lattice.h). This needs no recursion
+// and no search of the occupied nodes, and since all working memory is kept
+// between analyses, repeating one (e.g., in a measure) allocates nothing once
+// the system has stopped growing.
+
+#ifndef AMOEBOTSIM_CORE_CLUSTERANALYSIS_H_
+#define AMOEBOTSIM_CORE_CLUSTERANALYSIS_H_
+
+#include <vector>
+
+#include "core/lattice.h"
+
+class AmoebotParticle;
+
+class ClusterAnalysis {
+ public:
+  // Computes the clusters of the given particle list, whose particles must
+  // occupy the given lattice in the positions they are listed at (as in
+  // AmoebotSystem).
+  void analyze(const std::vector<AmoebotParticle*>& particles,
+               const Lattice<AmoebotParticle>& lattice);
+
+  // Functions for reading the result of the last analysis. Clusters are
+  // numbered in the order of their first particle in the particle list, and
+  // clusterOf returns the number of the cluster of the particle at the given
+  // position. largestClusterFraction is the fraction of all particles in the
+  // largest cluster, or 0 if there are none.
+  int numClusters() const;
+  const std::vector<int>& clusterSizes() const;
+  int clusterOf(int i) const;
+  int largestClusterSize() const;
+  double largestClusterFraction() const;
+
+ private:
+  // Union-find operations on particle positions, using union by size and path
+  // halving.
+  int find(int i);
+  void unite(int i, int j);
+
+  std::vector<int> _parent;
+  std::vector<int> _treeSize;
+  std::vector<int> _rootCluster;
+  std::vector<int> _clusterOf;
+  std::vector<int> _clusterSizes;
+  int _largestClusterSize = 0;
+};
+
+#endif  // AMOEBOTSIM_CORE_CLUSTERANALYSIS_H_
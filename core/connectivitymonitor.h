@@ -0,0 +1,245 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines an incremental tracker of whether the nodes occupied by particles
+// form one connected component. Rather than searching the whole system on
+// every query, the monitor is told about each node that becomes occupied or
+// vacant and updates its answer locally:
+//
+// - Occupying a node never disconnects a connected system; it keeps it
+//   connected if the node has an occupied neighbor.
+// - Vacating a node disconnects the system only if the node was an
+//   articulation point. Since consecutive neighbors of a node on the triangular
+//   lattice are adjacent to each other, this is only possible if its occupied
+//   neighbors form two or more separate runs around it. Otherwise the system is
+//   still connected. If there are separate runs, a breadth-first search of
+//   bounded size checks whether they are still joined elsewhere, which is
+//   usually resolved quickly around a small hole or a short dangling chain.
+//
+// Whenever a local update is inconclusive, the monitor forgets its answer and
+// stops tracking until the owner has run a full search on the next query; see
+// AmoebotSystem::isConnected.
+
+#ifndef AMOEBOTSIM_CORE_CONNECTIVITYMONITOR_H_
+#define AMOEBOTSIM_CORE_CONNECTIVITYMONITOR_H_
+
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <vector>
+
+#include <QtGlobal>
+
+#include "core/lattice.h"
+#include "core/node.h"
+
+template<class ParticleType>
+class ConnectivityMonitor {
+ public:
+  // Constructs a monitor of the particle occupancy of the given lattice, which
+  // must be empty. Its connectivity is unknown until first set, and while it
+  // is unknown, reported changes are only counted; tracking thus costs nothing
+  // until connectivity is first queried.
+  explicit ConnectivityMonitor(const Lattice<ParticleType>& lattice);
+
+  // Functions for reporting occupancy changes, which must be called after the
+  // lattice has been updated. Moves that hand a node over from one particle to
+  // another don't change the occupied nodes and need not be reported.
+  void nodeOccupied(const Node& node);
+  void nodeVacated(const Node& node);
+
+  // Returns whether the monitor currently knows if the occupied nodes are
+  // connected, and if so, whether they are.
+  bool isKnown() const;
+  bool isConnected() const;
+
+  // Records the result of a full connectivity check, from which point on the
+  // monitor tracks connectivity incrementally again.
+  void setConnected(const bool connected);
+
+  // Returns the number of occupied nodes.
+  unsigned int numOccupiedNodes() const;
+
+  // The maximum number of nodes a single bounded search may visit before it
+  // gives up.
+  static constexpr unsigned int searchBudget = 512;
+
+ private:
+  enum class Status {
+    Connected,
+    Disconnected,
+    Unknown
+  };
+
+  enum class SearchResult {
+    FoundAll,   // Every target was reached.
+    Exhausted,  // The start's whole component was visited, missing a target.
+    OutOfBudget
+  };
+
+  // Returns one occupied neighbor of the given node for each maximal run of
+  // consecutive occupied neighbors around it.
+  std::vector<Node> neighborRuns(const Node& node) const;
+
+  // Searches the occupied nodes breadth-first from start until all targets are
+  // reached, start's component is exhausted, or searchBudget nodes have been
+  // visited.
+  SearchResult search(const Node& start,
+                      const std::vector<Node>& targets) const;
+
+  // Decides whether the given runs around a vacated node are still joined,
+  // returning Status::Unknown if the bounded searches can't tell.
+  Status joinRuns(const std::vector<Node>& runs) const;
+
+  const Lattice<ParticleType>& _lattice;
+  Status _status;
+  unsigned int _numOccupiedNodes;
+};
+
+template<class ParticleType>
+ConnectivityMonitor<ParticleType>::ConnectivityMonitor(
+    const Lattice<ParticleType>& lattice)
+  : _lattice(lattice),
+    _status(Status::Unknown),
+    _numOccupiedNodes(0) {}
+
+template<class ParticleType>
+void ConnectivityMonitor<ParticleType>::nodeOccupied(const Node& node) {
+  ++_numOccupiedNodes;
+  if (_status == Status::Unknown) {
+    return;
+  }
+
+  const bool hasOccupiedNbr = !neighborRuns(node).empty();
+  if (_numOccupiedNodes == 1) {
+    _status = Status::Connected;
+  } else if (_status == Status::Connected && !hasOccupiedNbr) {
+    _status = Status::Disconnected;
+  } else if (_status == Status::Disconnected && hasOccupiedNbr) {
+    // The new node may bridge two components.
+    _status = Status::Unknown;
+  }
+}
+
+template<class ParticleType>
+void ConnectivityMonitor<ParticleType>::nodeVacated(const Node& node) {
+  Q_ASSERT(_numOccupiedNodes > 0);
+
+  --_numOccupiedNodes;
+  if (_status == Status::Unknown) {
+    return;
+  }
+
+  const std::vector<Node> runs = neighborRuns(node);
+  if (_numOccupiedNodes <= 1) {
+    _status = Status::Connected;
+  } else if (_status == Status::Connected && runs.size() > 1) {
+    _status = joinRuns(runs);
+  } else if (_status == Status::Disconnected && runs.empty()) {
+    // The node may have been a component of its own.
+    _status = Status::Unknown;
+  }
+}
+
+template<class ParticleType>
+bool ConnectivityMonitor<ParticleType>::isKnown() const {
+  return _status != Status::Unknown;
+}
+
+template<class ParticleType>
+bool ConnectivityMonitor<ParticleType>::isConnected() const {
+  Q_ASSERT(isKnown());
+
+  return _status == Status::Connected;
+}
+
+template<class ParticleType>
+void ConnectivityMonitor<ParticleType>::setConnected(const bool connected) {
+  _status = connected ? Status::Connected : Status::Disconnected;
+}
+
+template<class ParticleType>
+unsigned int ConnectivityMonitor<ParticleType>::numOccupiedNodes() const {
+  return _numOccupiedNodes;
+}
+
+template<class ParticleType>
+std::vector<Node> ConnectivityMonitor<ParticleType>::neighborRuns(
+    const Node& node) const {
+  std::vector<Node> runs;
+  const unsigned int mask = _lattice.nbrMask(node);
+  for (int dir = 0; dir < 6; ++dir) {
+    const bool occupied = (mask >> dir) & 1;
+    const bool prevOccupied = (mask >> ((dir + 5) % 6)) & 1;
+    if (occupied && !prevOccupied) {
+      runs.push_back(node.nodeInDir(dir));
+    }
+  }
+
+  // If every neighbor is occupied, no run has a start but all form one run.
+  if (runs.empty() && mask != 0) {
+    runs.push_back(node.nodeInDir(0));
+  }
+
+  return runs;
+}
+
+template<class ParticleType>
+typename ConnectivityMonitor<ParticleType>::SearchResult
+ConnectivityMonitor<ParticleType>::search(
+    const Node& start, const std::vector<Node>& targets) const {
+  std::vector<Node> remaining(targets);
+  std::set<Node> visited = {start};
+  std::deque<Node> queue = {start};
+
+  while (!queue.empty()) {
+    const Node n = queue.front();
+    queue.pop_front();
+
+    remaining.erase(std::remove(remaining.begin(), remaining.end(), n),
+                    remaining.end());
+    if (remaining.empty()) {
+      return SearchResult::FoundAll;
+    }
+
+    for (int dir = 0; dir < 6; ++dir) {
+      const Node nbr = n.nodeInDir(dir);
+      if (_lattice.hasParticleAt(nbr) && visited.insert(nbr).second) {
+        if (visited.size() > searchBudget) {
+          return SearchResult::OutOfBudget;
+        }
+        queue.push_back(nbr);
+      }
+    }
+  }
+
+  return SearchResult::Exhausted;
+}
+
+template<class ParticleType>
+typename ConnectivityMonitor<ParticleType>::Status
+ConnectivityMonitor<ParticleType>::joinRuns(
+    const std::vector<Node>& runs) const {
+  // Search from the first run toward all others. If it gives up, a run cut off
+  // from the rest is likely small, so search from each remaining run back to
+  // the first one instead.
+  const std::vector<Node> others(runs.begin() + 1, runs.end());
+  switch (search(runs[0], others)) {
+    case SearchResult::FoundAll:    return Status::Connected;
+    case SearchResult::Exhausted:   return Status::Disconnected;
+    case SearchResult::OutOfBudget: break;
+  }
+
+  for (const Node& run : others) {
+    switch (search(run, {runs[0]})) {
+      case SearchResult::FoundAll:    break;
+      case SearchResult::Exhausted:   return Status::Disconnected;
+      case SearchResult::OutOfBudget: return Status::Unknown;
+    }
+  }
+
+  return Status::Connected;
+}
+
+#endif  // AMOEBOTSIM_CORE_CONNECTIVITYMONITOR_H_
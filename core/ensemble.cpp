@@ -0,0 +1,148 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/ensemble.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include <QtGlobal>
+
+#include "core/metric.h"
+
+Ensemble::Ensemble(const QString algorithm, SystemFactory factory,
+                   const int numReplicas, const uint64_t baseSeed,
+                   const int roundLimit)
+  : _algorithm(algorithm),
+    _factory(factory),
+    _baseSeed(baseSeed),
+    _roundLimit(roundLimit),
+    _results(std::max(numReplicas, 0)) {}
+
+bool Ensemble::run(int numThreads) {
+  if (numThreads <= 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  numThreads = std::min(numThreads, static_cast<int>(_results.size()));
+
+  // Replicas are independent and coarse-grained, so idle workers simply claim
+  // the next unstarted replica. This balances uneven replica runtimes as well
+  // as per-worker queues with stealing would, without any locking.
+  std::atomic<int> nextReplica(0);
+  auto worker = [this, &nextReplica]() {
+    for (int i = nextReplica++; i < static_cast<int>(_results.size());
+         i = nextReplica++) {
+      runReplica(i);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 1; t < numThreads; ++t) {
+    threads.emplace_back(worker);
+  }
+  worker();  // The calling thread works too.
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return std::all_of(_results.begin(), _results.end(),
+                     [](const Result& r) { return r.instantiated; });
+}
+
+const QString Ensemble::metricsAsJSON() const {
+  QString json = "{\"title\" : \"AmoebotSim Ensemble Metrics JSON\", ";
+  json += "\"datetime\" : \"" +
+          QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") + "\", ";
+  json += "\"algorithm\" : \"" + _algorithm + "\", ";
+
+  // Summarize the final value of each metric over the replicas that ran. All
+  // replicas are instances of the same algorithm, so they list the same
+  // metrics in the same order.
+  json += "\"summary\" : [";
+  const Result* first = nullptr;
+  for (const auto& r : _results) {
+    if (r.instantiated) {
+      first = &r;
+      break;
+    }
+  }
+  if (first != nullptr) {
+    for (unsigned int m = 0; m < first->finalValues.size(); ++m) {
+      double min = first->finalValues[m].second, max = min, sum = 0.0;
+      int numValues = 0;
+      for (const auto& r : _results) {
+        if (r.instantiated && m < r.finalValues.size()) {
+          const double value = r.finalValues[m].second;
+          min = std::min(min, value);
+          max = std::max(max, value);
+          sum += value;
+          ++numValues;
+        }
+      }
+      // Print 15 significant digits so that counts beyond a million (e.g., of
+      // activations) are written out exactly rather than rounded.
+      json += "{\"name\" : \"" + first->finalValues[m].first + "\", ";
+      json += "\"min\" : " + QString::number(min, 'g', 15) + ", ";
+      json += "\"mean\" : " + QString::number(sum / numValues, 'g', 15) +
+              ", ";
+      json += "\"max\" : " + QString::number(max, 'g', 15) + "}, ";
+    }
+    if (!first->finalValues.empty()) {
+      json.chop(2);  // Remove the last ", ".
+    }
+  }
+
+  json += "], \"replicas\" : [";
+  for (const auto& r : _results) {
+    json += r.instantiated ? r.json : "null";
+    json += ", ";
+  }
+  if (!_results.empty()) {
+    json.chop(2);  // Remove the last ", ".
+  }
+  json += "]}";
+  return json;
+}
+
+bool Ensemble::exportMetrics(const QString filePath) const {
+  QFile outFile(filePath);
+  if (!outFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    return false;
+  }
+  QTextStream outStream(&outFile);
+  outStream << metricsAsJSON();
+  outFile.close();
+
+  return true;
+}
+
+void Ensemble::runReplica(const int index) {
+  std::shared_ptr<System> system = _factory(_baseSeed + index);
+  if (system == nullptr) {
+    return;
+  }
+
+  // No other thread can see this system, so unlike Simulator there is no need
+  // to hold its mutex while running it.
+  const Count& rounds = system->getCount("# Rounds");
+  while (!system->hasTerminated() &&
+         (_roundLimit < 0 ||
+          rounds._value < static_cast<unsigned int>(_roundLimit))) {
+    system->activate();
+  }
+
+  Result& result = _results[index];
+  result.json = system->metricsAsJSON();
+  for (const auto& c : system->getCounts()) {
+    result.finalValues.push_back(std::make_pair(c->_name, c->_value));
+  }
+  for (const auto& m : system->getMeasures()) {
+    result.finalValues.push_back(std::make_pair(m->_name, m->calculate()));
+  }
+  result.instantiated = true;
+}
@@ -0,0 +1,75 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines an engine for running many independent replicas of the same
+// algorithm instance concurrently and merging their metrics into one JSON
+// document. Every replica owns its own system and hence its own random number
+// generator stream, so replicas share no mutable state and their results do
+// not depend on the number of threads they are run on.
+
+#ifndef AMOEBOTSIM_CORE_ENSEMBLE_H_
+#define AMOEBOTSIM_CORE_ENSEMBLE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <QString>
+
+#include "core/system.h"
+
+class Ensemble {
+ public:
+  // Creates the system of a replica from the given seed, or returns nullptr if
+  // it could not be instantiated. Called concurrently from worker threads, so
+  // it must not touch shared state.
+  using SystemFactory = std::function<std::shared_ptr<System>(uint64_t seed)>;
+
+  // Constructs an ensemble of numReplicas replicas of the systems created by
+  // factory, labeled with the given algorithm signature. Replica i is seeded
+  // with baseSeed + i so that any single replica can be reproduced on its own.
+  // If roundLimit is non-negative, replicas that have not terminated after that
+  // many rounds are stopped; see Simulator::runUntilTermination.
+  Ensemble(const QString algorithm, SystemFactory factory,
+           const int numReplicas, const uint64_t baseSeed,
+           const int roundLimit = -1);
+
+  // Runs all replicas on the given number of worker threads (one per hardware
+  // thread if numThreads <= 0), blocking until every replica has finished.
+  // Returns false if any replica could not be instantiated.
+  bool run(int numThreads = 0);
+
+  // Formats the metrics of all replicas as a JSON string. Each entry of
+  // "replicas" has the structure of a single run's metrics JSON, while
+  // "summary" gives the minimum, mean, and maximum final value of each metric
+  // across replicas. See the Usage documentation for the full structure.
+  const QString metricsAsJSON() const;
+
+  // Writes metricsAsJSON to the given file, returning false if it can't be
+  // opened.
+  bool exportMetrics(const QString filePath) const;
+
+ private:
+  // The outcome of a single replica: its metrics JSON and the value of each of
+  // its metrics once it stopped, in the order the system lists them.
+  struct Result {
+    bool instantiated = false;
+    QString json;
+    std::vector<std::pair<QString, double>> finalValues;
+  };
+
+  // Instantiates, runs, and records the result of the replica with the given
+  // index. Each worker writes only to its replica's own result slot.
+  void runReplica(const int index);
+
+  const QString _algorithm;
+  const SystemFactory _factory;
+  const uint64_t _baseSeed;
+  const int _roundLimit;
+  std::vector<Result> _results;
+};
+
+#endif  // AMOEBOTSIM_CORE_ENSEMBLE_H_
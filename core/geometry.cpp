@@ -0,0 +1,175 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/geometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <utility>
+
+namespace {
+
+// A node together with its position in the embedding.
+struct EmbeddedNode {
+  Node node;
+  double x;
+  double y;
+};
+
+EmbeddedNode embed(const Node& node) {
+  return {node, node.x + node.y / 2.0, node.y * std::sqrt(3.0) / 2.0};
+}
+
+bool encloses(const Disc& disc, const EmbeddedNode& p) {
+  // Allow for the rounding error of the disc's construction.
+  const double dx = p.x - disc.x, dy = p.y - disc.y;
+  return dx * dx + dy * dy <= disc.radius * disc.radius * (1 + 1e-10);
+}
+
+Disc discThrough(const EmbeddedNode& a, const EmbeddedNode& b) {
+  const double x = (a.x + b.x) / 2, y = (a.y + b.y) / 2;
+  return {x, y, std::hypot(a.x - x, a.y - y)};
+}
+
+Disc discThrough(const EmbeddedNode& a, const EmbeddedNode& b,
+                 const EmbeddedNode& c) {
+  // The circumcircle, relative to a. The nodes are never collinear, as no
+  // three vertices of a convex hull are.
+  const double bx = b.x - a.x, by = b.y - a.y;
+  const double cx = c.x - a.x, cy = c.y - a.y;
+  const double d = 2 * (bx * cy - by * cx);
+  const double b2 = bx * bx + by * by, c2 = cx * cx + cy * cy;
+  const double x = (cy * b2 - by * c2) / d, y = (bx * c2 - cx * b2) / d;
+  return {a.x + x, a.y + y, std::hypot(x, y)};
+}
+
+}  // namespace
+
+int64_t orient(const Node& a, const Node& b, const Node& c) {
+  return (int64_t(b.x) - a.x) * (int64_t(c.y) - a.y) -
+         (int64_t(b.y) - a.y) * (int64_t(c.x) - a.x);
+}
+
+double euclideanDistance(const Node& a, const Node& b) {
+  // The embedding maps a lattice vector (dx, dy) to one of squared length
+  // (dx + dy / 2)^2 + 3 dy^2 / 4 = dx^2 + dx dy + dy^2.
+  const double dx = double(b.x) - a.x;
+  const double dy = double(b.y) - a.y;
+  return std::sqrt(dx * dx + dx * dy + dy * dy);
+}
+
+void convexHull(std::vector<Node>& nodes, std::vector<Node>& hull) {
+  std::sort(nodes.begin(), nodes.end());
+  nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+  const int n = nodes.size();
+  if (n < 3) {
+    hull.assign(nodes.begin(), nodes.end());
+    return;
+  }
+
+  // Build the lower and then the upper hull, popping vertices at which the
+  // boundary does not turn counterclockwise. The upper hull ends at the first
+  // node again, which is dropped.
+  hull.resize(2 * n);
+  int k = 0;
+  for (int i = 0; i < n; ++i) {
+    while (k >= 2 && orient(hull[k - 2], hull[k - 1], nodes[i]) <= 0) {
+      --k;
+    }
+    hull[k++] = nodes[i];
+  }
+  for (int i = n - 2, lowerSize = k + 1; i >= 0; --i) {
+    while (k >= lowerSize && orient(hull[k - 2], hull[k - 1], nodes[i]) <= 0) {
+      --k;
+    }
+    hull[k++] = nodes[i];
+  }
+  hull.resize(k - 1);
+}
+
+double hullPerimeter(const std::vector<Node>& hull) {
+  double perimeter = 0.0;
+  for (unsigned int i = 0; i < hull.size(); ++i) {
+    perimeter += euclideanDistance(hull[i], hull[(i + 1) % hull.size()]);
+  }
+
+  return perimeter;
+}
+
+double hullArea(const std::vector<Node>& hull) {
+  // Shoelace formula in lattice coordinates, scaled by the embedding's
+  // determinant sqrt(3) / 2.
+  int64_t twiceArea = 0;
+  for (unsigned int i = 0; i < hull.size(); ++i) {
+    const Node& a = hull[i];
+    const Node& b = hull[(i + 1) % hull.size()];
+    twiceArea += int64_t(a.x) * b.y - int64_t(b.x) * a.y;
+  }
+
+  return std::abs(twiceArea) * std::sqrt(3.0) / 4.0;
+}
+
+Disc smallestEnclosingDisc(std::vector<Node>& nodes,
+                           std::vector<Node>& support) {
+  std::vector<Node> hull;
+  convexHull(nodes, hull);
+  if (hull.empty()) {
+    support.clear();
+    return {0.0, 0.0, 0.0};
+  }
+
+  // Shuffle deterministically, then move the given support to the front.
+  std::minstd_rand generator(1);
+  std::shuffle(hull.begin(), hull.end(), generator);
+  unsigned int numFront = 0;
+  for (const Node& node : support) {
+    auto it = std::find(hull.begin() + numFront, hull.end(), node);
+    if (it != hull.end()) {
+      std::swap(*it, hull[numFront++]);
+    }
+  }
+
+  std::vector<EmbeddedNode> points;
+  points.reserve(hull.size());
+  for (const Node& node : hull) {
+    points.push_back(embed(node));
+  }
+
+  // Every node outside the disc of the nodes before it lies on the boundary of
+  // theirs and its smallest enclosing disc, and so on for up to three nodes.
+  int i0 = 0, i1 = -1, i2 = -1;
+  Disc disc = {points[0].x, points[0].y, 0.0};
+  for (int i = 1; i < static_cast<int>(points.size()); ++i) {
+    if (encloses(disc, points[i])) {
+      continue;
+    }
+    disc = {points[i].x, points[i].y, 0.0};
+    i0 = i, i1 = -1, i2 = -1;
+    for (int j = 0; j < i; ++j) {
+      if (encloses(disc, points[j])) {
+        continue;
+      }
+      disc = discThrough(points[i], points[j]);
+      i1 = j, i2 = -1;
+      for (int k = 0; k < j; ++k) {
+        if (!encloses(disc, points[k])) {
+          disc = discThrough(points[i], points[j], points[k]);
+          i2 = k;
+        }
+      }
+    }
+  }
+
+  support.clear();
+  for (int i : {i0, i1, i2}) {
+    if (i >= 0) {
+      support.push_back(points[i].node);
+    }
+  }
+
+  return disc;
+}
@@ -0,0 +1,62 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines geometric primitives on nodes of the triangular lattice, e.g., for
+// measures of a system's shape. Nodes are embedded in the plane as usual for
+// the lattice, with node (x, y) at (x + y / 2, y * sqrt(3) / 2), so that
+// neighboring nodes are at distance 1. This embedding is a linear map that
+// preserves orientation, so every combinatorial question (e.g., which nodes
+// lie on the convex hull) can be answered exactly with integer arithmetic on
+// the lattice coordinates themselves; only lengths and areas are converted.
+
+#ifndef AMOEBOTSIM_CORE_GEOMETRY_H_
+#define AMOEBOTSIM_CORE_GEOMETRY_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "core/node.h"
+
+// A disc in the embedding, given by its center and radius.
+struct Disc {
+  double x;
+  double y;
+  double radius;
+};
+
+// Returns twice the signed area of the triangle (a, b, c) in lattice
+// coordinates, which is positive if the nodes are in counterclockwise order,
+// negative if they are in clockwise order, and zero if they are collinear.
+int64_t orient(const Node& a, const Node& b, const Node& c);
+
+// Returns the Euclidean distance between two nodes in the embedding.
+double euclideanDistance(const Node& a, const Node& b);
+
+// Computes the convex hull of the given nodes with Andrew's monotone chain
+// algorithm in O(n log n) time, storing its vertices in counterclockwise order
+// in hull. Nodes on the hull's boundary that are not vertices are omitted, so
+// the hull of collinear nodes consists of the two extreme ones. Sorts the
+// given nodes and removes duplicates as a side effect.
+void convexHull(std::vector<Node>& nodes, std::vector<Node>& hull);
+
+// Returns the Euclidean perimeter and area of the convex polygon with the
+// given vertices in order, as computed by convexHull. A polygon of two
+// vertices is a segment, whose perimeter counts it in both directions.
+double hullPerimeter(const std::vector<Node>& hull);
+double hullArea(const std::vector<Node>& hull);
+
+// Computes the smallest disc enclosing the given nodes. This disc is determined
+// by the convex hull's vertices alone, so the nodes are first reduced to those
+// (see convexHull, including its side effects). The iterative form of Welzl's
+// algorithm then finds the disc in expected time linear in the number of
+// vertices, without recursion. It works for any order of the vertices but
+// does the least work if the ones on the resulting disc's boundary come first,
+// so the vertices in support are considered first and all others in a fixed
+// pseudorandom order. On return, support holds the (at most three) vertices
+// defining the disc. Passing it back in thus warm-starts the computation for
+// a slightly changed set of nodes, e.g., in the next round of a simulation.
+Disc smallestEnclosingDisc(std::vector<Node>& nodes,
+                           std::vector<Node>& support);
+
+#endif  // AMOEBOTSIM_CORE_GEOMETRY_H_
@@ -0,0 +1,234 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a sparse occupancy store for the triangular lattice. The lattice is
+// cut into square tiles of (1 << tileBits)^2 nodes which are only allocated
+// once a node inside them is written (see core/tiledirectory.h), so looking up
+// a node costs one directory index and one tile index instead of a walk down a
+// balanced search tree.
+//
+// Each cell stores the particle occupying the node (if any) alongside a flag
+// marking whether an object occupies it, so a single probe answers both
+// questions.
+//
+// Each cell also keeps two 6-bit neighborhood masks of its node, in which bit
+// i describes the neighbor in global direction i: one marking the neighbors
+// occupied by particles and one marking the neighbors that are heads of
+// expanded particles. These are updated incrementally whenever a node's
+// occupancy (or expanded head status) changes, so a particle can read its
+// whole neighborhood with one probe instead of probing each neighbor.
+
+#ifndef AMOEBOTSIM_CORE_LATTICE_H_
+#define AMOEBOTSIM_CORE_LATTICE_H_
+
+#include <array>
+
+#include <QtGlobal>
+
+#include "core/node.h"
+#include "core/tiledirectory.h"
+
+template<class ParticleType>
+class Lattice {
+ public:
+  // A single node's worth of occupancy information.
+  struct Cell {
+    ParticleType* particle = nullptr;
+    bool object = false;
+    bool expandedHead = false;
+    unsigned char nbrMask = 0;
+    unsigned char expandedHeadNbrMask = 0;
+  };
+
+  // Constructs an empty lattice with no tiles allocated.
+  Lattice();
+
+  // Functions for reading the occupancy of a node. particleAt returns the
+  // particle occupying the given node or nullptr if there is none. These never
+  // allocate; nodes in unallocated tiles are simply unoccupied.
+  ParticleType* particleAt(const Node& node) const;
+  bool hasParticleAt(const Node& node) const;
+  bool hasObjectAt(const Node& node) const;
+
+  // Functions for reading the neighborhood masks of a node. nbrMask has bit i
+  // set iff the neighbor in global direction i is occupied by a particle, and
+  // expandedHeadNbrMask has bit i set iff that neighbor is the head of an
+  // expanded particle.
+  unsigned int nbrMask(const Node& node) const;
+  unsigned int expandedHeadNbrMask(const Node& node) const;
+
+  // Functions for writing the occupancy of a node. setParticleAt allocates the
+  // tile containing the node if necessary, while clearParticleAt never does.
+  // Changing which particle occupies an already occupied node (as in a
+  // handover) leaves the neighborhood masks untouched. setExpandedHeadAt marks
+  // whether the particle occupying the node is expanded with its head there;
+  // clearing a node also clears this mark.
+  void setParticleAt(const Node& node, ParticleType* particle);
+  void clearParticleAt(const Node& node);
+  void setExpandedHeadAt(const Node& node, const bool expandedHead);
+  void setObjectAt(const Node& node);
+
+  // Releases all tiles, returning the lattice to its freshly constructed state.
+  void clear();
+
+  // Returns the number of tiles currently allocated.
+  unsigned int numTiles() const;
+
+  static constexpr int tileBits = 5;
+  static constexpr int tileSize = 1 << tileBits;
+  static constexpr int tileMask = tileSize - 1;
+
+ private:
+  using Tile = std::array<Cell, tileSize * tileSize>;
+
+  // Returns the cell for the given node or nullptr if its tile is unallocated.
+  const Cell* findCell(const Node& node) const;
+  Cell* findCell(const Node& node);
+
+  // Returns the cell for the given node, allocating its tile (and growing the
+  // directory to reach it) if necessary.
+  Cell& cellAt(const Node& node);
+
+  // Toggles the bits describing the given node in the respective masks of its
+  // six neighbors, allocating their tiles if necessary.
+  void toggleInNbrMasks(const Node& node);
+  void toggleInExpandedHeadNbrMasks(const Node& node);
+
+  static int tileCoord(int coord);
+  static int cellIndex(const Node& node);
+
+  TileDirectory<Tile> _tiles;
+};
+
+template<class ParticleType>
+Lattice<ParticleType>::Lattice() {}
+
+template<class ParticleType>
+inline ParticleType* Lattice<ParticleType>::particleAt(const Node& node) const {
+  const Cell* cell = findCell(node);
+  return (cell != nullptr) ? cell->particle : nullptr;
+}
+
+template<class ParticleType>
+inline bool Lattice<ParticleType>::hasParticleAt(const Node& node) const {
+  return particleAt(node) != nullptr;
+}
+
+template<class ParticleType>
+inline bool Lattice<ParticleType>::hasObjectAt(const Node& node) const {
+  const Cell* cell = findCell(node);
+  return cell != nullptr && cell->object;
+}
+
+template<class ParticleType>
+inline unsigned int Lattice<ParticleType>::nbrMask(const Node& node) const {
+  const Cell* cell = findCell(node);
+  return (cell != nullptr) ? cell->nbrMask : 0;
+}
+
+template<class ParticleType>
+inline unsigned int Lattice<ParticleType>::expandedHeadNbrMask(
+    const Node& node) const {
+  const Cell* cell = findCell(node);
+  return (cell != nullptr) ? cell->expandedHeadNbrMask : 0;
+}
+
+template<class ParticleType>
+inline void Lattice<ParticleType>::setParticleAt(const Node& node,
+                                                 ParticleType* particle) {
+  Q_ASSERT(particle != nullptr);
+
+  Cell& cell = cellAt(node);
+  const bool wasOccupied = cell.particle != nullptr;
+  cell.particle = particle;
+  if (!wasOccupied) {
+    toggleInNbrMasks(node);
+  }
+}
+
+template<class ParticleType>
+inline void Lattice<ParticleType>::clearParticleAt(const Node& node) {
+  Cell* cell = findCell(node);
+  if (cell != nullptr && cell->particle != nullptr) {
+    setExpandedHeadAt(node, false);
+    cell->particle = nullptr;
+    toggleInNbrMasks(node);
+  }
+}
+
+template<class ParticleType>
+inline void Lattice<ParticleType>::setExpandedHeadAt(const Node& node,
+                                                     const bool expandedHead) {
+  Cell* cell = findCell(node);
+  Q_ASSERT(!expandedHead || (cell != nullptr && cell->particle != nullptr));
+
+  if (cell != nullptr && cell->expandedHead != expandedHead) {
+    cell->expandedHead = expandedHead;
+    toggleInExpandedHeadNbrMasks(node);
+  }
+}
+
+template<class ParticleType>
+void Lattice<ParticleType>::setObjectAt(const Node& node) {
+  cellAt(node).object = true;
+}
+
+template<class ParticleType>
+void Lattice<ParticleType>::clear() {
+  _tiles.clear();
+}
+
+template<class ParticleType>
+unsigned int Lattice<ParticleType>::numTiles() const {
+  return _tiles.numTiles();
+}
+
+template<class ParticleType>
+inline const typename Lattice<ParticleType>::Cell*
+Lattice<ParticleType>::findCell(const Node& node) const {
+  const Tile* tile = _tiles.find(tileCoord(node.x), tileCoord(node.y));
+  return (tile != nullptr) ? &(*tile)[cellIndex(node)] : nullptr;
+}
+
+template<class ParticleType>
+inline typename Lattice<ParticleType>::Cell*
+Lattice<ParticleType>::findCell(const Node& node) {
+  return const_cast<Cell*>(
+      static_cast<const Lattice<ParticleType>*>(this)->findCell(node));
+}
+
+template<class ParticleType>
+typename Lattice<ParticleType>::Cell&
+Lattice<ParticleType>::cellAt(const Node& node) {
+  return _tiles.at(tileCoord(node.x), tileCoord(node.y))[cellIndex(node)];
+}
+
+template<class ParticleType>
+void Lattice<ParticleType>::toggleInNbrMasks(const Node& node) {
+  // The neighbor in direction dir sees this node in the opposite direction.
+  for (int dir = 0; dir < 6; ++dir) {
+    cellAt(node.nodeInDir(dir)).nbrMask ^= 1 << ((dir + 3) % 6);
+  }
+}
+
+template<class ParticleType>
+void Lattice<ParticleType>::toggleInExpandedHeadNbrMasks(const Node& node) {
+  for (int dir = 0; dir < 6; ++dir) {
+    cellAt(node.nodeInDir(dir)).expandedHeadNbrMask ^= 1 << ((dir + 3) % 6);
+  }
+}
+
+template<class ParticleType>
+inline int Lattice<ParticleType>::tileCoord(int coord) {
+  // Arithmetic shift rounds toward negative infinity, as required for nodes
+  // with negative coordinates.
+  return coord >> tileBits;
+}
+
+template<class ParticleType>
+inline int Lattice<ParticleType>::cellIndex(const Node& node) {
+  return ((node.y & tileMask) << tileBits) | (node.x & tileMask);
+}
+
+#endif  // AMOEBOTSIM_CORE_LATTICE_H_
@@ -0,0 +1,79 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/memorypool.h"
+
+#include <algorithm>
+#include <new>
+
+#include <QtGlobal>
+
+MemoryPool::MemoryPool()
+  : chunkNext(nullptr),
+    chunkEnd(nullptr) {}
+
+MemoryPool::~MemoryPool() {
+  for (void* block : largeBlocks) {
+    ::operator delete(block);
+  }
+}
+
+void* MemoryPool::allocate(std::size_t size) {
+  if (size > maxBlockSize) {
+    void* block = ::operator new(size);
+    largeBlocks.insert(block);
+    return block;
+  }
+
+  const std::size_t cls = sizeClass(size);
+  if (cls < freeLists.size() && freeLists[cls] != nullptr) {
+    FreeBlock* block = freeLists[cls];
+    freeLists[cls] = block->next;
+    return block;
+  }
+
+  // Carve a new block off the current chunk, starting a new chunk if it is
+  // exhausted. The unused tail of the old chunk is simply abandoned.
+  const std::size_t bytes = cls * alignment;
+  if (chunkNext == nullptr ||
+      static_cast<std::size_t>(chunkEnd - chunkNext) < bytes) {
+    chunks.emplace_back(new char[chunkSize]);
+    chunkNext = chunks.back().get();
+    chunkEnd = chunkNext + chunkSize;
+  }
+  void* block = chunkNext;
+  chunkNext += bytes;
+
+  return block;
+}
+
+void MemoryPool::deallocate(void* block, std::size_t size) {
+  if (block == nullptr) {
+    return;
+  } else if (size > maxBlockSize) {
+    Q_ASSERT(largeBlocks.count(block) == 1);
+    largeBlocks.erase(block);
+    ::operator delete(block);
+    return;
+  }
+
+  const std::size_t cls = sizeClass(size);
+  if (cls >= freeLists.size()) {
+    freeLists.resize(cls + 1, nullptr);
+  }
+  FreeBlock* freed = static_cast<FreeBlock*>(block);
+  freed->next = freeLists[cls];
+  freeLists[cls] = freed;
+}
+
+std::size_t MemoryPool::bytesReserved() const {
+  return chunks.size() * chunkSize;
+}
+
+std::size_t MemoryPool::sizeClass(std::size_t size) {
+  Q_ASSERT(size <= maxBlockSize);
+
+  // Every block must be able to hold a FreeBlock once it is freed.
+  return (std::max(size, sizeof(FreeBlock)) + alignment - 1) / alignment;
+}
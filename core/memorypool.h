@@ -0,0 +1,122 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a memory pool for the many small, equally sized objects a system
+// allocates over and over (particles and tokens). Blocks are carved out of
+// large chunks and recycled through one free list per size class, so that
+// steady-state allocation never reaches the global heap and objects of the
+// same type end up close together. All chunks are released at once when the
+// pool is destroyed.
+//
+// A pool is not thread-safe; each system owns its own pools and is only ever
+// modified by one thread at a time.
+
+#ifndef AMOEBOTSIM_CORE_MEMORYPOOL_H_
+#define AMOEBOTSIM_CORE_MEMORYPOOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+class MemoryPool {
+ public:
+  // Constructs an empty pool that has not reserved any memory yet.
+  MemoryPool();
+
+  // Releases all chunks of this pool and all blocks passed through to the
+  // global heap, regardless of whether they have been deallocated. Any objects
+  // still living in them must have been destructed already.
+  ~MemoryPool();
+
+  MemoryPool(const MemoryPool& other) = delete;
+  MemoryPool& operator=(const MemoryPool& other) = delete;
+
+  // Returns a block of at least the given size, aligned for any fundamental
+  // type. Blocks larger than maxBlockSize are passed through to the global
+  // heap, but are still tracked by the pool so that they are released with it.
+  void* allocate(std::size_t size);
+
+  // Returns the given block, which must have been allocated from this pool
+  // with the same size, to its size class's free list.
+  void deallocate(void* block, std::size_t size);
+
+  // Returns the number of bytes reserved in chunks so far.
+  std::size_t bytesReserved() const;
+
+  static constexpr std::size_t alignment = alignof(std::max_align_t);
+  static constexpr std::size_t chunkSize = 1 << 16;
+  static constexpr std::size_t maxBlockSize = chunkSize / 16;
+
+ private:
+  // Freed blocks are linked through their own storage.
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  // Returns the size class of blocks of the given size, i.e., the number of
+  // alignment units they span.
+  static std::size_t sizeClass(std::size_t size);
+
+  std::vector<FreeBlock*> freeLists;
+  std::vector<std::unique_ptr<char[]>> chunks;
+  std::unordered_set<void*> largeBlocks;
+  char* chunkNext;
+  char* chunkEnd;
+};
+
+// A standard allocator drawing from a MemoryPool, e.g. for std::allocate_shared
+// to place an object and its reference count in a single pooled block.
+template<class T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  explicit PoolAllocator(MemoryPool& pool);
+  template<class U>
+  PoolAllocator(const PoolAllocator<U>& other);
+
+  T* allocate(std::size_t n);
+  void deallocate(T* p, std::size_t n);
+
+ private:
+  template<class U>
+  friend class PoolAllocator;
+  template<class T1, class T2>
+  friend bool operator==(const PoolAllocator<T1>& a,
+                         const PoolAllocator<T2>& b);
+
+  MemoryPool* _pool;
+};
+
+template<class T>
+PoolAllocator<T>::PoolAllocator(MemoryPool& pool)
+  : _pool(&pool) {}
+
+template<class T>
+template<class U>
+PoolAllocator<T>::PoolAllocator(const PoolAllocator<U>& other)
+  : _pool(other._pool) {}
+
+template<class T>
+T* PoolAllocator<T>::allocate(std::size_t n) {
+  return static_cast<T*>(_pool->allocate(n * sizeof(T)));
+}
+
+template<class T>
+void PoolAllocator<T>::deallocate(T* p, std::size_t n) {
+  _pool->deallocate(p, n * sizeof(T));
+}
+
+template<class T1, class T2>
+bool operator==(const PoolAllocator<T1>& a, const PoolAllocator<T2>& b) {
+  return a._pool == b._pool;
+}
+
+template<class T1, class T2>
+bool operator!=(const PoolAllocator<T1>& a, const PoolAllocator<T2>& b) {
+  return !(a == b);
+}
+
+#endif  // AMOEBOTSIM_CORE_MEMORYPOOL_H_
@@ -8,11 +8,15 @@
 #ifndef AMOEBOTSIM_CORE_METRIC_H_
 #define AMOEBOTSIM_CORE_METRIC_H_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <map>
 #include <vector>
 
 #include <QString>
+#include <QtGlobal>
 
 class Count {
  public:
@@ -26,9 +30,10 @@ class Count {
   // Member variables. The count's name should be human-readable, as it is used
   // to represent this count in the GUI. The value of the count is what is
   // incremented. History records the count values over time, once per round.
+  // Both are 64 bits wide, as long runs can exceed 2^32 activations.
   const QString _name;
-  unsigned int _value;
-  std::vector<int> _history;
+  quint64 _value;
+  std::vector<quint64> _history;
 };
 
 class Measure {
@@ -52,4 +57,64 @@ class Measure {
   std::vector<double> _history;
 };
 
+// A measure whose value is a function of running sums over the system, e.g.,
+// the number of particles in some state or the sum of their coordinates.
+// Instead of the measure recomputing the sums from the whole system whenever
+// it is due, the system or its particles record every change to them as it
+// happens, so calculate() takes constant time regardless of the system size.
+// The sums are integers, so they never drift from the values a recomputation
+// would give.
+template<std::size_t NumSums>
+class IncrementalMeasure : public Measure {
+ public:
+  using Sums = std::array<int64_t, NumSums>;
+
+  // Constructs a new measure with a given name and calculation frequency whose
+  // sums are all zero.
+  IncrementalMeasure(const QString name, const unsigned int freq);
+
+  // Adds the given change to the sums, e.g., {1} when a particle enters a
+  // counted state and {-1} when it leaves it.
+  void record(const Sums& delta);
+
+  // Returns the current sums.
+  const Sums& sums() const;
+
+  // Returns the measure's value for the current sums.
+  double calculate() const final;
+
+ protected:
+  // Computes the measure's value from the given sums. This must be overridden
+  // by child classes.
+  virtual double value(const Sums& sums) const = 0;
+
+ private:
+  Sums _sums;
+};
+
+template<std::size_t NumSums>
+IncrementalMeasure<NumSums>::IncrementalMeasure(const QString name,
+                                                const unsigned int freq)
+  : Measure(name, freq) {
+  _sums.fill(0);
+}
+
+template<std::size_t NumSums>
+inline void IncrementalMeasure<NumSums>::record(const Sums& delta) {
+  for (std::size_t i = 0; i < NumSums; ++i) {
+    _sums[i] += delta[i];
+  }
+}
+
+template<std::size_t NumSums>
+inline const typename IncrementalMeasure<NumSums>::Sums&
+IncrementalMeasure<NumSums>::sums() const {
+  return _sums;
+}
+
+template<std::size_t NumSums>
+double IncrementalMeasure<NumSums>::calculate() const {
+  return value(_sums);
+}
+
 #endif  // AMOEBOTSIM_CORE_METRIC_H_
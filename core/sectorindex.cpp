@@ -0,0 +1,151 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/sectorindex.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <QtGlobal>
+
+void SectorIndex::insert(const Node& node) {
+  _columns.insert(node.x, node.y);
+  _rows.insert(node.y, node.x);
+}
+
+void SectorIndex::remove(const Node& node) {
+  _columns.remove(node.x, node.y);
+  _rows.remove(node.y, node.x);
+}
+
+void SectorIndex::move(const Node& from, const Node& to) {
+  remove(from);
+  insert(to);
+}
+
+bool SectorIndex::anyInSector(const Node& apex, int sector) const {
+  const int minKey = std::numeric_limits<int>::min();
+  const int maxKey = std::numeric_limits<int>::max();
+  const int x = apex.x, y = apex.y, u = apex.x + apex.y;
+
+  switch (sector) {
+    case 0:  // x >= x', y > y'.
+      return _columns.query(x, maxKey).maxValue > y;
+    case 1:  // x < x', u >= u'.
+      return _columns.query(minKey, x - 1).maxSum >= u;
+    case 2:  // y >= y', u < u'.
+      return _rows.query(y, maxKey).minSum < u;
+    case 3:  // x <= x', y < y'.
+      return _columns.query(minKey, x).minValue < y;
+    case 4:  // x > x', u <= u'.
+      return _columns.query(x + 1, maxKey).minSum <= u;
+    case 5:  // y <= y', u > u'.
+      return _rows.query(minKey, y).maxSum > u;
+    default:
+      Q_ASSERT(0 <= sector && sector < 6);
+      return false;
+  }
+}
+
+void SectorIndex::LineTree::insert(int key, int value) {
+  growToInclude(key);
+  const bool inserted = _lines[key - _firstKey].insert(value).second;
+  Q_ASSERT(inserted);
+  Q_UNUSED(inserted);
+  update(key);
+}
+
+void SectorIndex::LineTree::remove(int key, int value) {
+  Q_ASSERT(_firstKey <= key && key - _firstKey < int(_lines.size()));
+  const bool removed = _lines[key - _firstKey].erase(value) == 1;
+  Q_ASSERT(removed);
+  Q_UNUSED(removed);
+  update(key);
+}
+
+SectorIndex::Extremes SectorIndex::LineTree::query(int lo, int hi) const {
+  const int size = _lines.size();
+  lo = std::max(lo, _firstKey);
+  hi = std::min(hi, _firstKey + size - 1);
+
+  // Combine the maximal subtrees covering [lo, hi], bottom-up.
+  Extremes result = empty();
+  if (lo <= hi) {
+    for (int l = lo - _firstKey + size, r = hi - _firstKey + size + 1; l < r;
+         l /= 2, r /= 2) {
+      if (l % 2 == 1) {
+        result = combine(result, _tree[l++]);
+      }
+      if (r % 2 == 1) {
+        result = combine(result, _tree[--r]);
+      }
+    }
+  }
+
+  return result;
+}
+
+SectorIndex::Extremes SectorIndex::LineTree::empty() {
+  return {std::numeric_limits<int>::max(), std::numeric_limits<int>::min(),
+          std::numeric_limits<int>::max(), std::numeric_limits<int>::min()};
+}
+
+SectorIndex::Extremes SectorIndex::LineTree::combine(const Extremes& a,
+                                                     const Extremes& b) {
+  return {std::min(a.minValue, b.minValue), std::max(a.maxValue, b.maxValue),
+          std::min(a.minSum, b.minSum), std::max(a.maxSum, b.maxSum)};
+}
+
+SectorIndex::Extremes SectorIndex::LineTree::lineExtremes(
+    int key, const std::set<int>& line) {
+  if (line.empty()) {
+    return empty();
+  }
+
+  return {*line.begin(), *line.rbegin(), key + *line.begin(),
+          key + *line.rbegin()};
+}
+
+void SectorIndex::LineTree::growToInclude(int key) {
+  int size = _lines.size();
+  if (size == 0) {
+    size = 64;
+    _firstKey = key - size / 2;
+  } else if (_firstKey <= key && key - _firstKey < size) {
+    return;
+  }
+
+  // Double the range toward the key until it is included.
+  const int oldFirstKey = _firstKey;
+  const int oldSize = _lines.size();
+  while (key < _firstKey || key - _firstKey >= size) {
+    if (key < _firstKey) {
+      _firstKey -= size;
+    }
+    size *= 2;
+  }
+
+  std::vector<std::set<int>> lines(size);
+  for (int i = 0; i < oldSize; ++i) {
+    lines[oldFirstKey - _firstKey + i] = std::move(_lines[i]);
+  }
+  _lines = std::move(lines);
+
+  _tree.assign(2 * size, empty());
+  for (int i = 0; i < size; ++i) {
+    _tree[size + i] = lineExtremes(_firstKey + i, _lines[i]);
+  }
+  for (int i = size - 1; i > 0; --i) {
+    _tree[i] = combine(_tree[2 * i], _tree[2 * i + 1]);
+  }
+}
+
+void SectorIndex::LineTree::update(int key) {
+  int i = key - _firstKey + _lines.size();
+  _tree[i] = lineExtremes(key, _lines[key - _firstKey]);
+  for (i /= 2; i > 0; i /= 2) {
+    _tree[i] = combine(_tree[2 * i], _tree[2 * i + 1]);
+  }
+}
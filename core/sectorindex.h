@@ -0,0 +1,80 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines a spatial index over a set of nodes answering whether any of them
+// lies in a 60 degree sector around a given node, as needed by particles that
+// "see" along a cone (see alg/aggregation.h). Sector d is the open cone
+// between the rays from the apex in global directions d (excluded) and
+// d + 1 (included), so the apex itself is never in a sector.
+//
+// Writing a node as (x, y) and u = x + y, every sector is a quadrant in one
+// pair of these coordinates; e.g., sector 0 holds the nodes with x >= x' and
+// y > y' for apex (x', y'). A quadrant is nonempty if and only if the extreme
+// value of the second coordinate over the lines of the first one in range
+// passes the apex's, so the index keeps the nodes on every column (fixed x)
+// and row (fixed y) and a segment tree over each for these extremes. Queries
+// and updates thus take logarithmic time instead of a pass over all nodes.
+
+#ifndef AMOEBOTSIM_CORE_SECTORINDEX_H_
+#define AMOEBOTSIM_CORE_SECTORINDEX_H_
+
+#include <set>
+#include <vector>
+
+#include "core/node.h"
+
+class SectorIndex {
+ public:
+  // Functions for updating the set of indexed nodes. A node must not be
+  // inserted twice, and only indexed nodes can be removed or moved.
+  void insert(const Node& node);
+  void remove(const Node& node);
+  void move(const Node& from, const Node& to);
+
+  // Returns whether any indexed node lies in the given sector of the apex.
+  bool anyInSector(const Node& apex, int sector) const;
+
+ private:
+  // The extremes over a set of nodes on lines of fixed key k with values v,
+  // namely of v and of k + v.
+  struct Extremes {
+    int minValue;
+    int maxValue;
+    int minSum;
+    int maxSum;
+  };
+
+  // Nodes grouped into lines by one coordinate (the key) and sorted along the
+  // line by the other (the value), with a segment tree of the extremes of the
+  // lines. The tree spans a power-of-two range of keys that grows as needed.
+  class LineTree {
+   public:
+    void insert(int key, int value);
+    void remove(int key, int value);
+
+    // Returns the extremes over the lines with keys in [lo, hi].
+    Extremes query(int lo, int hi) const;
+
+   private:
+    static Extremes empty();
+    static Extremes combine(const Extremes& a, const Extremes& b);
+    static Extremes lineExtremes(int key, const std::set<int>& line);
+
+    // Grows the range of keys to include the given key.
+    void growToInclude(int key);
+
+    // Recomputes the extremes of the given line and its ancestors in the tree.
+    void update(int key);
+
+    int _firstKey = 0;
+    std::vector<std::set<int>> _lines;
+    std::vector<Extremes> _tree;
+  };
+
+  // Lines of fixed x holding y, and of fixed y holding x, respectively.
+  LineTree _columns;
+  LineTree _rows;
+};
+
+#endif  // AMOEBOTSIM_CORE_SECTORINDEX_H_
@@ -4,6 +4,9 @@
 
 #include "core/simulator.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include <QCoreApplication>
 #include <QDateTime>
 #include <QDir>
@@ -14,20 +17,24 @@
 
 #include "core/metric.h"
 
-Simulator::Simulator() {
-  stepTimer.setInterval(100);
-  connect(&stepTimer, &QTimer::timeout, this, &Simulator::step);
-}
+Simulator::Simulator()
+  : running(false),
+    stepDuration(100),
+    batchSize(1),
+    batchBudget(10) {}
 
 Simulator::~Simulator() {
-  stepTimer.stop();
+  stop();
 }
 
 void Simulator::setSystem(std::shared_ptr<System> _system) {
-  stepTimer.stop();
-  emit stopped();
+  stop();
 
   system = _system;
+  if (system != nullptr) {
+    QMutexLocker locker(&system->mutex);
+    publishSnapshot(*system);
+  }
   emit systemChanged(system);
 }
 
@@ -36,20 +43,34 @@ std::shared_ptr<System> Simulator::getSystem() const {
 }
 
 void Simulator::start() {
-  stepTimer.start();
+  if (system == nullptr || worker.joinable()) {
+    return;
+  }
+
+  running = true;
+  worker = std::thread(&Simulator::runWorker, this, system);
   emit started();
 }
 
 void Simulator::stop() {
-  stepTimer.stop();
+  if (worker.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(wakeMutex);
+      running = false;
+    }
+    wakeCondition.notify_all();
+    worker.join();
+  }
   emit stopped();
 }
 
 void Simulator::step() {
   QMutexLocker locker(&system->mutex);
   system->activate();
+  publishSnapshot(*system);
 
   if (system->hasTerminated()) {
+    locker.unlock();
     stop();
   }
 }
@@ -57,18 +78,47 @@ void Simulator::step() {
 void Simulator::stepForParticleAt(Node node) {
   QMutexLocker locker(&system->mutex);
   system->activateParticleAt(node);
+  publishSnapshot(*system);
 }
 
 void Simulator::setStepDuration(int ms) {
-  stepTimer.setInterval(ms);
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    stepDuration = ms;
+  }
+  wakeCondition.notify_all();
   emit stepDurationChanged(ms);
 }
 
-void Simulator::runUntilTermination() {
+void Simulator::setBatchSize(int size) {
+  Q_ASSERT(size >= 0);
+  batchSize = size;
+  emit batchSizeChanged(size);
+}
+
+void Simulator::setBatchBudget(int ms) {
+  Q_ASSERT(ms > 0);
+  batchBudget = ms;
+}
+
+void Simulator::runUntilTermination(const int roundLimit) {
+  if (worker.joinable()) {
+    stop();
+  }
+
   QMutexLocker locker(&system->mutex);
-  while (!system->hasTerminated()) {
-    system->activate();
+  if (roundLimit < 0) {
+    while (!system->hasTerminated()) {
+      system->activate();
+    }
+  } else {
+    const Count& rounds = system->getCount("# Rounds");
+    while (!system->hasTerminated() &&
+           rounds._value < static_cast<unsigned int>(roundLimit)) {
+      system->activate();
+    }
   }
+  publishSnapshot(*system);
 }
 
 int Simulator::numParticles() const {
@@ -82,23 +132,16 @@ int Simulator::numObjects() const {
 }
 
 QVariant Simulator::metrics() const {
-  QMutexLocker locker(&system->mutex);
-  QList<QVariant> metricsData;
-  for (const auto& c : system->getCounts()) {
-    metricsData.push_back(QVariant({c->_name, c->_value}));
-  }
-  for (const auto& m : system->getMeasures()) {
-    if (m->_history.empty()) {
-      metricsData.push_back(QVariant({m->_name, 0.0}));
-    } else {
-      metricsData.push_back(QVariant({m->_name, m->_history.back()}));
-    }
+  // Reading the latest snapshot instead of the live system keeps the per-frame
+  // metrics refresh from contending with the worker thread for the mutex.
+  auto snapshot = (system != nullptr) ? system->snapshots.latest() : nullptr;
+  if (snapshot == nullptr) {
+    return QVariant::fromValue(QList<QVariant>());
   }
-  return QVariant::fromValue(metricsData);
+  return QVariant::fromValue(snapshot->metrics);
 }
 
 void Simulator::exportMetrics() {
-  QMutexLocker locker(&system->mutex);
   QDir metricsDir(QCoreApplication::applicationDirPath());
   #ifdef Q_OS_MACOS
     metricsDir.cd("../../..");  // Escape the macOS application bundle.
@@ -107,17 +150,93 @@ void Simulator::exportMetrics() {
     metricsDir.mkdir("metrics");
     metricsDir.cd("metrics");
   }
-  QFile outFile(metricsDir.path() + "/metrics_" +
+  exportMetrics(metricsDir.path() + "/metrics_" +
                 QString::number(QDateTime::currentSecsSinceEpoch()) + ".json");
+}
+
+bool Simulator::exportMetrics(const QString filePath) {
+  QMutexLocker locker(&system->mutex);
+  QFile outFile(filePath);
   if (!outFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-    return;
+    return false;
   }
   QTextStream outStream(&outFile);
   outStream << system->metricsAsJSON();
   outFile.close();
+
+  return true;
 }
 
 void Simulator::saveScreenshotSetup(const QString filePath) {
   emit systemChanged(system);
   emit saveScreenshot(filePath);
 }
+
+void Simulator::runWorker(std::shared_ptr<System> workerSystem) {
+  using Clock = std::chrono::steady_clock;
+
+  // The batch size used in adaptive mode, carried over between steps.
+  int adaptiveSize = 1;
+
+  while (running) {
+    const int size = batchSize;
+    bool terminated;
+    {
+      QMutexLocker locker(&workerSystem->mutex);
+      const auto begin = Clock::now();
+      const int numActivations = activateBatch(
+          *workerSystem, (size > 0) ? size : adaptiveSize, terminated);
+
+      if (size == 0 && !terminated) {
+        // Scale the batch toward the time budget based on how long this one
+        // took, at most doubling or halving it at once so that a single
+        // unusually slow or fast step doesn't make the size swing wildly.
+        const double elapsed = std::chrono::duration<double, std::milli>(
+              Clock::now() - begin).count();
+        const double target = (elapsed > 0.0)
+            ? numActivations * (batchBudget / elapsed)
+            : 2.0 * adaptiveSize;
+        adaptiveSize = static_cast<int>(std::max(
+            std::min(target, 2.0 * adaptiveSize), adaptiveSize / 2.0));
+        adaptiveSize = std::max(adaptiveSize, 1);
+      }
+
+      if (terminated || workerSystem->snapshots.wanted()) {
+        publishSnapshot(*workerSystem);
+      }
+    }
+
+    if (terminated) {
+      // Only the thread that started the worker may join it, so hand the rest
+      // of stopping over to it.
+      running = false;
+      QMetaObject::invokeMethod(this, "stop", Qt::QueuedConnection);
+      return;
+    }
+
+    const int ms = stepDuration;
+    if (ms > 0) {
+      std::unique_lock<std::mutex> lock(wakeMutex);
+      wakeCondition.wait_for(lock, std::chrono::milliseconds(ms),
+                             [this, ms]() {
+        return !running || stepDuration != ms;
+      });
+    }
+  }
+}
+
+int Simulator::activateBatch(System& system, const int size, bool& terminated) {
+  terminated = false;
+  int numActivations = 0;
+  while (numActivations < size && !terminated) {
+    system.activate();
+    ++numActivations;
+    terminated = system.hasTerminated();
+  }
+
+  return numActivations;
+}
+
+void Simulator::publishSnapshot(System& system) {
+  system.snapshots.publish(std::make_shared<SystemSnapshot>(system));
+}
@@ -5,14 +5,23 @@
 #ifndef AMOEBOTSIM_CORE_SIMULATOR_H_
 #define AMOEBOTSIM_CORE_SIMULATOR_H_
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include <QObject>
-#include <QTimer>
 #include <QVariant>
 
 #include "core/system.h"
 
+// The simulator owns the system being simulated. While started, it activates
+// particles on a dedicated worker thread, taking the system's mutex for each
+// activation so that the GUI and scripts can still query and step the system
+// from their own thread. After an activation, the worker publishes a snapshot
+// of the system if the renderer has taken the previous one (see
+// core/snapshot.h), so drawing never blocks simulation and vice versa.
 class Simulator : public QObject {
   Q_OBJECT
 
@@ -26,23 +35,38 @@ class Simulator : public QObject {
  signals:
   void systemChanged(std::shared_ptr<System> _system);
   void stepDurationChanged(int ms);
+  void batchSizeChanged(int size);
   void saveScreenshot(const QString filePath);
 
   void started();
   void stopped();
 
  public slots:
-  // Responds to control flow signals from the GUI and scripts. Start, stop, and
-  // step are self-explanatory. stepForParticleAt executes one activation for
-  // the specific particle at the given node. setStepDuration updates the delay
-  // in milliseconds between particle activations. runUntilTermination activates
-  // particles repeatedly until the hasTerminated condition is satisfied.
+  // Responds to control flow signals from the GUI and scripts. Start and stop
+  // launch and join the worker thread; stop blocks until the worker has
+  // finished its current activation. step executes one activation on the
+  // calling thread. stepForParticleAt executes one activation for the specific
+  // particle at the given node. setStepDuration updates the delay in
+  // milliseconds between the worker's steps. runUntilTermination activates
+  // particles repeatedly on the calling thread, stopping the worker first,
+  // until the hasTerminated condition is satisfied or, if a positive round
+  // limit is given, until that many rounds have completed.
   void start();
   void stop();
   void step();
   void stepForParticleAt(Node node);
   void setStepDuration(int ms);
-  void runUntilTermination();
+  void runUntilTermination(const int roundLimit = -1);
+
+  // Controls how many activations the worker executes per step, all under a
+  // single acquisition of the system's mutex and followed by at most one
+  // snapshot. setBatchSize fixes this number to the given positive value; a
+  // batch size of 0 instead adapts the number of activations so that each step
+  // takes about as long as the budget set by setBatchBudget (in milliseconds),
+  // which bounds how long the GUI may wait for the mutex. The default batch
+  // size of 1 executes one activation per step.
+  void setBatchSize(int size);
+  void setBatchBudget(int ms);
 
   // Responds to GUI and script requests for statistics and metrics.
   int numParticles() const;
@@ -51,16 +75,40 @@ class Simulator : public QObject {
 
   // Responds to the exportMetrics signal from the GUI and scripts by creating
   // an output file with a unique timestamp (to avoid accidental overwrites) and
-  // writing the metrics JSON to it.
+  // writing the metrics JSON to it. The overload taking a file path writes the
+  // metrics JSON to that file instead, returning false if it can't be opened.
   void exportMetrics();
+  bool exportMetrics(const QString filePath);
 
   // Emits a signal that updates the system visually, followed by a signal that
   // takes a screenshot of the result.
   void saveScreenshotSetup(const QString filePath);
 
  protected:
-  QTimer stepTimer;
+  // The worker thread's main loop, which runs until stop is requested or the
+  // system terminates.
+  void runWorker(std::shared_ptr<System> workerSystem);
+
+  // Executes up to size activations of the given system, stopping early if it
+  // terminates. Returns the number of activations executed. The caller must
+  // hold the system's mutex.
+  static int activateBatch(System& system, const int size, bool& terminated);
+
+  // Captures a snapshot of the given system and publishes it to the system's
+  // snapshot buffer. The caller must hold the system's mutex.
+  static void publishSnapshot(System& system);
+
   std::shared_ptr<System> system;
+
+  std::thread worker;
+  std::atomic<bool> running;
+  std::atomic<int> stepDuration;
+  std::atomic<int> batchSize;
+  std::atomic<int> batchBudget;
+
+  // Used to wake the worker early from the delay between activations.
+  std::mutex wakeMutex;
+  std::condition_variable wakeCondition;
 };
 
 #endif  // AMOEBOTSIM_CORE_SIMULATOR_H_
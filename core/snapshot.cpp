@@ -0,0 +1,87 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/snapshot.h"
+
+#include <QMutexLocker>
+
+#include "core/metric.h"
+#include "core/system.h"
+
+ParticleSnapshot::ParticleSnapshot(const Particle& p)
+  : Particle(p.head, p.globalTailDir),
+    _headMarkColor(p.headMarkColor()),
+    _tailMarkColor(p.tailMarkColor()),
+    _headMarkGlobalDir(p.headMarkGlobalDir()),
+    _tailMarkGlobalDir(p.tailMarkGlobalDir()),
+    _borderColors(p.borderColors()),
+    _borderPointColors(p.borderPointColors()) {}
+
+int ParticleSnapshot::headMarkColor() const {
+  return _headMarkColor;
+}
+
+int ParticleSnapshot::tailMarkColor() const {
+  return _tailMarkColor;
+}
+
+int ParticleSnapshot::headMarkGlobalDir() const {
+  return _headMarkGlobalDir;
+}
+
+int ParticleSnapshot::tailMarkGlobalDir() const {
+  return _tailMarkGlobalDir;
+}
+
+std::array<int, 18> ParticleSnapshot::borderColors() const {
+  return _borderColors;
+}
+
+std::array<int, 6> ParticleSnapshot::borderPointColors() const {
+  return _borderPointColors;
+}
+
+SystemSnapshot::SystemSnapshot(const System& system) {
+  particles.reserve(system.size());
+  for (const Particle& p : system) {
+    particles.emplace_back(p);
+  }
+
+  objects.reserve(system.numObjects());
+  for (const Object* o : system.getObjects()) {
+    objects.push_back(*o);
+  }
+
+  for (const auto& c : system.getCounts()) {
+    metrics.push_back(QVariant({c->_name, c->_value}));
+  }
+  for (const auto& m : system.getMeasures()) {
+    if (m->_history.empty()) {
+      metrics.push_back(QVariant({m->_name, 0.0}));
+    } else {
+      metrics.push_back(QVariant({m->_name, m->_history.back()}));
+    }
+  }
+  metrics.push_back(
+      QVariant({"Seed", QVariant(QString::number(system.getSeed()))}));
+}
+
+SnapshotBuffer::SnapshotBuffer()
+  : _wanted(true) {}
+
+void SnapshotBuffer::publish(std::shared_ptr<const SystemSnapshot> snapshot) {
+  QMutexLocker locker(&mutex);
+  _latest = snapshot;
+  _wanted = false;
+}
+
+std::shared_ptr<const SystemSnapshot> SnapshotBuffer::latest() {
+  QMutexLocker locker(&mutex);
+  _wanted = true;
+  return _latest;
+}
+
+bool SnapshotBuffer::wanted() const {
+  return _wanted;
+}
@@ -0,0 +1,89 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines immutable copies of a system's visible state. The simulation thread
+// captures a snapshot of its system and publishes it to the system's
+// SnapshotBuffer, from which the renderer reads the latest one without holding
+// the system's mutex. Stepping and drawing thus never wait on each other.
+
+#ifndef AMOEBOTSIM_CORE_SNAPSHOT_H_
+#define AMOEBOTSIM_CORE_SNAPSHOT_H_
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QList>
+#include <QMutex>
+#include <QVariant>
+
+#include "core/object.h"
+#include "core/particle.h"
+
+// System is forward declared to avoid a cyclic dependency with SnapshotBuffer.
+class System;
+
+class ParticleSnapshot : public Particle {
+ public:
+  // Constructs a copy of the given particle's position and cosmetic
+  // appearance, evaluating its virtual appearance functions once.
+  explicit ParticleSnapshot(const Particle& p);
+
+  // Overrides returning the appearance captured at construction.
+  int headMarkColor() const final;
+  int tailMarkColor() const final;
+  int headMarkGlobalDir() const final;
+  int tailMarkGlobalDir() const final;
+  std::array<int, 18> borderColors() const final;
+  std::array<int, 6> borderPointColors() const final;
+
+ private:
+  int _headMarkColor, _tailMarkColor;
+  int _headMarkGlobalDir, _tailMarkGlobalDir;
+  std::array<int, 18> _borderColors;
+  std::array<int, 6> _borderPointColors;
+};
+
+class SystemSnapshot {
+ public:
+  // Captures the particles, objects, and current metric values of the given
+  // system. The caller must hold the system's mutex or otherwise ensure it is
+  // not being modified.
+  explicit SystemSnapshot(const System& system);
+
+  std::vector<ParticleSnapshot> particles;
+  std::vector<Object> objects;
+
+  // (name, value) pairs of the system's counts and latest measures, followed
+  // by its seed, in the form shown by the GUI's metrics panel.
+  QList<QVariant> metrics;
+};
+
+class SnapshotBuffer {
+ public:
+  // Constructs an empty buffer that wants its first snapshot.
+  SnapshotBuffer();
+
+  // Replaces the latest snapshot. Readers holding the previous one keep it
+  // alive until they are done with it.
+  void publish(std::shared_ptr<const SystemSnapshot> snapshot);
+
+  // Returns the latest snapshot (nullptr if none was published yet) and marks
+  // that a newer one is wanted.
+  std::shared_ptr<const SystemSnapshot> latest();
+
+  // Returns whether a reader has taken the latest snapshot since it was
+  // published, in which case capturing a new one is worthwhile. Publishers
+  // poll this after each activation so that snapshots are captured no more
+  // often than they are drawn.
+  bool wanted() const;
+
+ private:
+  QMutex mutex;
+  std::shared_ptr<const SystemSnapshot> _latest;
+  std::atomic<bool> _wanted;
+};
+
+#endif  // AMOEBOTSIM_CORE_SNAPSHOT_H_
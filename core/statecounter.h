@@ -0,0 +1,153 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines population counters for particle states. A particle stores its state
+// in a CountedState, which behaves like a plain enum value but keeps the
+// StateCounter it was registered with up to date on every assignment and on
+// destruction. Termination predicates can then ask how many particles are in
+// a given state in constant time instead of scanning every particle.
+//
+// Counters are owned by AmoebotSystem, which hands out one per state enum type;
+// see AmoebotSystem::stateCounter.
+
+#ifndef AMOEBOTSIM_CORE_STATECOUNTER_H_
+#define AMOEBOTSIM_CORE_STATECOUNTER_H_
+
+#include <initializer_list>
+#include <vector>
+
+#include <QtGlobal>
+
+// StateCounterBase allows counters for different state types to be stored
+// together.
+class StateCounterBase {
+ public:
+  virtual ~StateCounterBase() = default;
+};
+
+template<class State>
+class StateCounter : public StateCounterBase {
+ public:
+  // Returns the number of particles currently in the given state, or in any of
+  // the given states, respectively.
+  int count(const State state) const;
+  int count(std::initializer_list<State> states) const;
+
+  // Returns the number of particles registered with this counter.
+  int total() const;
+
+  // Registers a particle entering or leaving the given state. These are called
+  // by CountedState and should not need to be called directly.
+  void add(const State state);
+  void remove(const State state);
+
+ private:
+  // Indexed by the integer value of a state; grows to fit the largest state
+  // seen so far.
+  std::vector<int> _counts;
+  int _total = 0;
+};
+
+template<class State>
+class CountedState {
+ public:
+  // Constructs a state with the given initial value, registered with the given
+  // counter.
+  CountedState(StateCounter<State>& counter, const State state);
+
+  // Unregisters the state from its counter.
+  ~CountedState();
+
+  // Counted states are tied to their counter, so they can't be copied; copy
+  // assignment only transfers the value.
+  CountedState(const CountedState& other) = delete;
+  CountedState& operator=(const CountedState& other);
+
+  // Changes the state, moving it from its old state's count to the new one.
+  CountedState& operator=(const State state);
+
+  // Returns the current state, allowing a CountedState to be compared and
+  // switched on like the enum it wraps.
+  operator State() const;
+
+ private:
+  StateCounter<State>& _counter;
+  State _state;
+};
+
+template<class State>
+int StateCounter<State>::count(const State state) const {
+  const unsigned int index = static_cast<unsigned int>(state);
+  return (index < _counts.size()) ? _counts[index] : 0;
+}
+
+template<class State>
+int StateCounter<State>::count(std::initializer_list<State> states) const {
+  int sum = 0;
+  for (const State state : states) {
+    sum += count(state);
+  }
+
+  return sum;
+}
+
+template<class State>
+int StateCounter<State>::total() const {
+  return _total;
+}
+
+template<class State>
+void StateCounter<State>::add(const State state) {
+  const unsigned int index = static_cast<unsigned int>(state);
+  if (index >= _counts.size()) {
+    _counts.resize(index + 1, 0);
+  }
+  ++_counts[index];
+  ++_total;
+}
+
+template<class State>
+void StateCounter<State>::remove(const State state) {
+  const unsigned int index = static_cast<unsigned int>(state);
+  Q_ASSERT(index < _counts.size() && _counts[index] > 0);
+  --_counts[index];
+  --_total;
+}
+
+template<class State>
+CountedState<State>::CountedState(StateCounter<State>& counter,
+                                  const State state)
+  : _counter(counter),
+    _state(state) {
+  _counter.add(_state);
+}
+
+template<class State>
+CountedState<State>::~CountedState() {
+  _counter.remove(_state);
+}
+
+template<class State>
+CountedState<State>& CountedState<State>::operator=(
+    const CountedState& other) {
+  return *this = other._state;
+}
+
+template<class State>
+CountedState<State>& CountedState<State>::operator=(const State state) {
+  if (state != _state) {
+    _counter.remove(_state);
+    _counter.add(state);
+    _state = state;
+  }
+
+  return *this;
+}
+
+template<class State>
+CountedState<State>::operator State() const {
+  return _state;
+}
+
+#endif  // AMOEBOTSIM_CORE_STATECOUNTER_H_
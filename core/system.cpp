@@ -4,6 +4,9 @@
 
 #include "core/system.h"
 
+#include <QDateTime>
+#include <QtGlobal>
+
 SystemIterator::SystemIterator(const System* system, int pos)
   : _pos(pos)
   , system(system) {}
@@ -32,3 +35,62 @@ SystemIterator System::end() const {
 bool System::hasTerminated() const {
   return false;
 }
+
+Count& System::getCount(QString name) const {
+  for (const auto& c : getCounts()) {
+    if (QString::compare(c->_name, name) == 0) {
+      return *c;
+    }
+  }
+  Q_ASSERT(false);  // Requested count does not exist.
+}
+
+Measure& System::getMeasure(QString name) const {
+  for (const auto& m : getMeasures()) {
+    if (QString::compare(m->_name, name) == 0) {
+      return *m;
+    }
+  }
+  Q_ASSERT(false);  // Requested measure does not exist.
+}
+
+const QString System::metricsAsJSON() const {
+  QString json = "{\"title\" : \"AmoebotSim Metrics JSON\", ";
+  json += "\"datetime\" : \"" +
+          QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") + "\", ";
+  json += "\"algorithm\" : \"???\", ";
+  json += "\"seed\" : " + QString::number(getSeed()) + ", ";
+  json += "\"counts\" : [";
+  for (const auto& c : getCounts()) {
+    json += "{\"name\" : \"" + c->_name + "\", ";
+    json += "\"history\" : [";
+    for (auto val : c->_history) {
+      json += QString::number(val) += ", ";
+    }
+    if (!c->_history.empty()) {
+      json.chop(2);  // Remove the last ", ".
+    }
+    json += "]}, ";
+  }
+  if (!getCounts().empty()) {
+    json.chop(2);  // Remove the last ", ".
+  }
+  json += "], \"measures\" : [";
+  for (const auto& m : getMeasures()) {
+    json += "{\"name\" : \"" + m->_name + "\", ";
+    json += "\"frequency\" : " + QString::number(m->_freq) + ", ";
+    json += "\"history\" : [";
+    for (auto val : m->_history) {
+      json += QString::number(val) += ", ";
+    }
+    if (!m->_history.empty()) {
+      json.chop(2);  // Remove the last ", ".
+    }
+    json += "]}, ";
+  }
+  if (!getMeasures().empty()) {
+    json.chop(2);  // Remove the last ", ".
+  }
+  json += "]}";
+  return json;
+}
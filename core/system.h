@@ -8,6 +8,7 @@
 #ifndef AMOEBOTSIM_CORE_SYSTEM_H_
 #define AMOEBOTSIM_CORE_SYSTEM_H_
 
+#include <cstdint>
 #include <deque>
 #include <set>
 
@@ -18,6 +19,7 @@
 #include "core/node.h"
 #include "core/object.h"
 #include "core/particle.h"
+#include "core/snapshot.h"
 
 // System is forward declared to avoid a cyclic dependency with SystemIterator.
 class System;
@@ -66,23 +68,37 @@ class System {
   SystemIterator begin() const;
   SystemIterator end() const;
 
-  // Various access function signatures for metrics (counts and measures). These
-  // are pure virtual at this level; see amoebotsystem.h for their overrides.
+  // Various access functions for metrics (counts and measures). getCounts and
+  // getMeasures are pure virtual at this level; see amoebotsystem.h for their
+  // overrides. getCount (resp., getMeasure) returns a reference to the named
+  // count (resp., measure) and crashes if it is not found. metricsAsJSON
+  // formats the count and measure histories as a JSON string; its structure
+  // can be found in the Usage documentation.
   virtual const std::vector<Count*>& getCounts() const = 0;
   virtual const std::vector<Measure*>& getMeasures() const = 0;
-  virtual Count& getCount(QString name) const = 0;
-  virtual Measure& getMeasure(QString name) const = 0;
-  virtual const QString metricsAsJSON() const = 0;
+  virtual Count& getCount(QString name) const;
+  virtual Measure& getMeasure(QString name) const;
+  virtual const QString metricsAsJSON() const;
+
+  // Returns the seed of the random number generator stream driving this
+  // system, which reproduces the run when passed back in at instantiation.
+  virtual uint64_t getSeed() const = 0;
 
   virtual bool hasTerminated() const;
 
  protected:
-  // Checks whether the particle system forms one connected component.
+  // Checks whether the particle system forms one connected component by a
+  // breadth-first search over all of its nodes. AmoebotSystem::isConnected
+  // answers the same question incrementally and should be preferred.
   template<class ParticleContainer>
   static bool isConnected(const ParticleContainer& particles);
 
  public:
   QMutex mutex;
+
+  // The latest snapshot of this system published by the simulator, which
+  // renderers read instead of locking mutex.
+  SnapshotBuffer snapshots;
 };
 
 template<class ParticleContainer>
@@ -95,9 +111,13 @@ bool System::isConnected(const ParticleContainer& particles) {
     }
   }
 
+  if (occupiedNodes.empty()) {
+    return true;
+  }
+
   std::deque<Node> queue;
   queue.push_back(*occupiedNodes.begin());
-  occupiedNodes.clear(); // remove the first node already
+  occupiedNodes.erase(occupiedNodes.begin());
 
   while (!queue.empty()) {
     Node n = queue.front();
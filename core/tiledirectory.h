@@ -0,0 +1,151 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines the sparse tile storage shared by the lattice occupancy stores (see
+// core/lattice.h and core/bitlattice.h). The lattice is cut into square tiles
+// which are only allocated once something inside them is written. Tiles are
+// addressed through a dense directory keyed by tile coordinate that grows to
+// cover the bounding box of all allocated tiles, so finding a tile costs one
+// directory index instead of a walk down a balanced search tree.
+
+#ifndef AMOEBOTSIM_CORE_TILEDIRECTORY_H_
+#define AMOEBOTSIM_CORE_TILEDIRECTORY_H_
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+template<class Tile>
+class TileDirectory {
+ public:
+  // Constructs an empty directory with no tiles allocated.
+  TileDirectory();
+
+  // Returns the tile at the given tile coordinate or nullptr if it is
+  // unallocated. Never allocates.
+  const Tile* find(int tileX, int tileY) const;
+  Tile* find(int tileX, int tileY);
+
+  // Returns the tile at the given tile coordinate, value-initializing it (and
+  // growing the directory to reach it) if necessary.
+  Tile& at(int tileX, int tileY);
+
+  // Releases all tiles, returning the directory to its freshly constructed
+  // state.
+  void clear();
+
+  // Returns the number of tiles currently allocated.
+  unsigned int numTiles() const;
+
+ private:
+  // Grows the directory so that it covers the given tile coordinate.
+  void growToInclude(int tileX, int tileY);
+
+  // The directory covers tile coordinates [_minTileX, _minTileX + _width) x
+  // [_minTileY, _minTileY + _height), stored row-major.
+  int _minTileX, _minTileY;
+  int _width, _height;
+  std::vector<std::unique_ptr<Tile>> _tiles;
+  unsigned int _numTiles;
+};
+
+template<class Tile>
+TileDirectory<Tile>::TileDirectory()
+  : _minTileX(0),
+    _minTileY(0),
+    _width(0),
+    _height(0),
+    _numTiles(0) {}
+
+template<class Tile>
+inline const Tile* TileDirectory<Tile>::find(int tileX, int tileY) const {
+  // Casting to unsigned folds the lower and upper bounds checks into one.
+  const unsigned int tx = tileX - _minTileX;
+  const unsigned int ty = tileY - _minTileY;
+  if (tx >= static_cast<unsigned int>(_width) ||
+      ty >= static_cast<unsigned int>(_height)) {
+    return nullptr;
+  }
+
+  return _tiles[ty * _width + tx].get();
+}
+
+template<class Tile>
+inline Tile* TileDirectory<Tile>::find(int tileX, int tileY) {
+  return const_cast<Tile*>(
+      static_cast<const TileDirectory<Tile>*>(this)->find(tileX, tileY));
+}
+
+template<class Tile>
+Tile& TileDirectory<Tile>::at(int tileX, int tileY) {
+  growToInclude(tileX, tileY);
+
+  auto& tile = _tiles[(tileY - _minTileY) * _width + (tileX - _minTileX)];
+  if (tile == nullptr) {
+    tile.reset(new Tile());
+    ++_numTiles;
+  }
+
+  return *tile;
+}
+
+template<class Tile>
+void TileDirectory<Tile>::clear() {
+  _tiles.clear();
+  _minTileX = _minTileY = 0;
+  _width = _height = 0;
+  _numTiles = 0;
+}
+
+template<class Tile>
+unsigned int TileDirectory<Tile>::numTiles() const {
+  return _numTiles;
+}
+
+template<class Tile>
+void TileDirectory<Tile>::growToInclude(int tileX, int tileY) {
+  if (_width > 0 && _minTileX <= tileX && tileX < _minTileX + _width &&
+      _minTileY <= tileY && tileY < _minTileY + _height) {
+    return;
+  }
+
+  // Grow by at least the current extent on the side being extended so that a
+  // system drifting in one direction only triggers logarithmically many
+  // directory rebuilds.
+  int minX = tileX, maxX = tileX, minY = tileY, maxY = tileY;
+  if (_width > 0) {
+    minX = std::min(minX, _minTileX);
+    maxX = std::max(maxX, _minTileX + _width - 1);
+    minY = std::min(minY, _minTileY);
+    maxY = std::max(maxY, _minTileY + _height - 1);
+    if (tileX < _minTileX) {
+      minX = std::min(minX, _minTileX - _width);
+    } else if (tileX >= _minTileX + _width) {
+      maxX = std::max(maxX, _minTileX + 2 * _width - 1);
+    }
+    if (tileY < _minTileY) {
+      minY = std::min(minY, _minTileY - _height);
+    } else if (tileY >= _minTileY + _height) {
+      maxY = std::max(maxY, _minTileY + 2 * _height - 1);
+    }
+  }
+
+  const int width = maxX - minX + 1;
+  const int height = maxY - minY + 1;
+  std::vector<std::unique_ptr<Tile>> tiles(width * height);
+  for (int y = 0; y < _height; ++y) {
+    for (int x = 0; x < _width; ++x) {
+      tiles[(y + _minTileY - minY) * width + (x + _minTileX - minX)] =
+          std::move(_tiles[y * _width + x]);
+    }
+  }
+
+  _tiles.swap(tiles);
+  _minTileX = minX;
+  _minTileY = minY;
+  _width = width;
+  _height = height;
+}
+
+#endif  // AMOEBOTSIM_CORE_TILEDIRECTORY_H_
@@ -0,0 +1,18 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+#include "core/tokenstore.h"
+
+#include <map>
+#include <mutex>
+#include <typeindex>
+
+int tokenTypeId(const std::type_info& type) {
+  static std::mutex mutex;
+  static std::map<std::type_index, int> ids;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  const int nextId = static_cast<int>(ids.size());
+  return ids.emplace(type, nextId).first->second;
+}
@@ -0,0 +1,238 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines the container in which a particle keeps its tokens. Tokens are kept
+// in one FIFO bucket per concrete token type, so a query for a type only has
+// to look at the buckets of the (few) types the particle currently holds
+// instead of casting every single token. Whether a bucket's type matches a
+// queried type is determined once per pair of types with a single cast and
+// remembered from then on; queries for a base type (e.g., one shared by
+// several token structs) thus see the tokens of all its derived types.
+//
+// Every token is stamped with the order in which it was put, so a query
+// spanning several buckets still returns the token that was put first.
+
+#ifndef AMOEBOTSIM_CORE_TOKENSTORE_H_
+#define AMOEBOTSIM_CORE_TOKENSTORE_H_
+
+#include <functional>
+#include <memory>
+#include <typeinfo>
+#include <vector>
+
+#include <QtGlobal>
+
+// Returns a small integer identifying the given type, assigning the next free
+// one the first time a type is seen. The compile-time version caches the id of
+// its type so that it is only looked up once.
+int tokenTypeId(const std::type_info& type);
+template<class TokenType>
+int tokenTypeId();
+
+template<class Token>
+class TokenStore {
+ public:
+  // Property checks as used by AmoebotParticle's token functions. An empty
+  // function accepts every token.
+  template<class TokenType>
+  using PropertyCheck = std::function<bool(const std::shared_ptr<TokenType>)>;
+
+  // Adds the given token to the back of its type's bucket.
+  template<class TokenType>
+  void put(std::shared_ptr<TokenType> token);
+
+  // Returns the earliest put token of the given type satisfying the property,
+  // or nullptr if there is none. take additionally removes the token.
+  template<class TokenType>
+  std::shared_ptr<TokenType> peek(
+      const PropertyCheck<TokenType>& propertyCheck = nullptr) const;
+  template<class TokenType>
+  std::shared_ptr<TokenType> take(
+      const PropertyCheck<TokenType>& propertyCheck = nullptr);
+
+  // Returns the number of tokens of the given type satisfying the property.
+  // Without a property check this only adds up bucket sizes.
+  template<class TokenType>
+  int count(const PropertyCheck<TokenType>& propertyCheck = nullptr) const;
+
+  // Returns the total number of tokens in this store.
+  int size() const;
+
+ private:
+  struct Entry {
+    unsigned long long order;
+    std::shared_ptr<Token> token;
+  };
+
+  struct Bucket {
+    int typeId;
+    std::vector<Entry> entries;
+  };
+
+  // Returns whether the tokens in the given nonempty bucket are of the given
+  // type.
+  template<class TokenType>
+  static bool matches(const Bucket& bucket);
+
+  // Locates the earliest put token of the given type satisfying the property,
+  // returning false if there is none.
+  template<class TokenType>
+  bool find(const PropertyCheck<TokenType>& propertyCheck,
+            unsigned int& bucketIndex, unsigned int& entryIndex) const;
+
+  // Buckets are kept once created, as particles tend to hold the same few
+  // token types over and over.
+  std::vector<Bucket> buckets;
+  unsigned long long nextOrder = 0;
+};
+
+template<class TokenType>
+int tokenTypeId() {
+  static const int id = tokenTypeId(typeid(TokenType));
+  return id;
+}
+
+template<class Token>
+template<class TokenType>
+void TokenStore<Token>::put(std::shared_ptr<TokenType> token) {
+  Q_ASSERT(token != nullptr);
+
+  // The token's concrete type is usually its static type, whose id is cached.
+  const std::type_info& type = typeid(*token);
+  const int typeId = (type == typeid(TokenType)) ? tokenTypeId<TokenType>()
+                                                 : tokenTypeId(type);
+
+  Entry entry = {nextOrder++, std::move(token)};
+  for (Bucket& bucket : buckets) {
+    if (bucket.typeId == typeId) {
+      bucket.entries.push_back(std::move(entry));
+      return;
+    }
+  }
+  buckets.push_back({typeId, {}});
+  buckets.back().entries.push_back(std::move(entry));
+}
+
+template<class Token>
+template<class TokenType>
+std::shared_ptr<TokenType> TokenStore<Token>::peek(
+    const PropertyCheck<TokenType>& propertyCheck) const {
+  unsigned int bucketIndex, entryIndex;
+  if (!find<TokenType>(propertyCheck, bucketIndex, entryIndex)) {
+    return nullptr;
+  }
+
+  return std::static_pointer_cast<TokenType>(
+      buckets[bucketIndex].entries[entryIndex].token);
+}
+
+template<class Token>
+template<class TokenType>
+std::shared_ptr<TokenType> TokenStore<Token>::take(
+    const PropertyCheck<TokenType>& propertyCheck) {
+  unsigned int bucketIndex, entryIndex;
+  if (!find<TokenType>(propertyCheck, bucketIndex, entryIndex)) {
+    return nullptr;
+  }
+
+  std::vector<Entry>& entries = buckets[bucketIndex].entries;
+  std::shared_ptr<TokenType> token =
+      std::static_pointer_cast<TokenType>(entries[entryIndex].token);
+  entries.erase(entries.begin() + entryIndex);
+
+  return token;
+}
+
+template<class Token>
+template<class TokenType>
+int TokenStore<Token>::count(
+    const PropertyCheck<TokenType>& propertyCheck) const {
+  int count = 0;
+  for (const Bucket& bucket : buckets) {
+    if (bucket.entries.empty() || !matches<TokenType>(bucket)) {
+      continue;
+    } else if (!propertyCheck) {
+      count += bucket.entries.size();
+      continue;
+    }
+
+    for (const Entry& entry : bucket.entries) {
+      if (propertyCheck(std::static_pointer_cast<TokenType>(entry.token))) {
+        count++;
+      }
+    }
+  }
+
+  return count;
+}
+
+template<class Token>
+int TokenStore<Token>::size() const {
+  int size = 0;
+  for (const Bucket& bucket : buckets) {
+    size += bucket.entries.size();
+  }
+
+  return size;
+}
+
+template<class Token>
+template<class TokenType>
+bool TokenStore<Token>::matches(const Bucket& bucket) {
+  Q_ASSERT(!bucket.entries.empty());
+
+  if (bucket.typeId == tokenTypeId<TokenType>()) {
+    return true;
+  }
+
+  // Whether one type derives from another never changes, so it is decided by
+  // casting a sample token once. The cache is per thread, as independent
+  // systems may be simulated concurrently; see core/ensemble.h.
+  static thread_local std::vector<signed char> derives;
+  const unsigned int index = static_cast<unsigned int>(bucket.typeId);
+  if (index >= derives.size()) {
+    derives.resize(index + 1, -1);
+  }
+  if (derives[index] < 0) {
+    derives[index] =
+        dynamic_cast<const TokenType*>(bucket.entries[0].token.get()) !=
+        nullptr;
+  }
+
+  return derives[index] == 1;
+}
+
+template<class Token>
+template<class TokenType>
+bool TokenStore<Token>::find(const PropertyCheck<TokenType>& propertyCheck,
+                             unsigned int& bucketIndex,
+                             unsigned int& entryIndex) const {
+  bool found = false;
+  unsigned long long foundOrder = 0;
+  for (unsigned int i = 0; i < buckets.size(); i++) {
+    const std::vector<Entry>& entries = buckets[i].entries;
+    if (entries.empty() || !matches<TokenType>(buckets[i])) {
+      continue;
+    }
+
+    // Entries within a bucket are in put order, so the search of a bucket can
+    // stop as soon as it passes the best token found so far.
+    for (unsigned int j = 0; j < entries.size(); j++) {
+      if (found && entries[j].order > foundOrder) {
+        break;
+      } else if (!propertyCheck || propertyCheck(
+          std::static_pointer_cast<TokenType>(entries[j].token))) {
+        found = true;
+        foundOrder = entries[j].order;
+        bucketIndex = i;
+        entryIndex = j;
+        break;
+      }
+    }
+  }
+
+  return found;
+}
+
+#endif  // AMOEBOTSIM_CORE_TOKENSTORE_H_
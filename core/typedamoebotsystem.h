@@ -0,0 +1,161 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Defines an amoebot system whose particles are all of one known type. Since
+// only particles of that type can be inserted, the system (and its particles,
+// through AmoebotParticle::nbrAtLabel) can treat every particle as that type
+// with a static_cast instead of checking it with a dynamic_cast on every
+// access. In debug builds, the types are still checked.
+//
+// Algorithms whose systems consist of one particle type should derive their
+// system from TypedAmoebotSystem<TheirParticle>, iterate over
+// typedParticles(), and use particleAt() instead of casting particles
+// themselves.
+
+#ifndef AMOEBOTSIM_CORE_TYPEDAMOEBOTSYSTEM_H_
+#define AMOEBOTSIM_CORE_TYPEDAMOEBOTSYSTEM_H_
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include <QtGlobal>
+
+#include "core/amoebotparticle.h"
+#include "core/amoebotsystem.h"
+#include "core/object.h"
+
+template<class ParticleType>
+class TypedAmoebotSystem : public AmoebotSystem {
+ public:
+  // An iterator over the particle list yielding ParticleType pointers.
+  class ParticleIterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ParticleType*;
+    using difference_type = std::ptrdiff_t;
+    using pointer = ParticleType**;
+    using reference = ParticleType*;
+
+    explicit ParticleIterator(
+        std::vector<AmoebotParticle*>::const_iterator it);
+
+    ParticleType* operator*() const;
+    ParticleIterator& operator++();
+    bool operator==(const ParticleIterator& other) const;
+    bool operator!=(const ParticleIterator& other) const;
+
+   private:
+    std::vector<AmoebotParticle*>::const_iterator _it;
+  };
+
+  // A view of the particle list, for use in range-based for loops.
+  class ParticleRange {
+   public:
+    explicit ParticleRange(const std::vector<AmoebotParticle*>& particles);
+
+    ParticleIterator begin() const;
+    ParticleIterator end() const;
+
+   private:
+    const std::vector<AmoebotParticle*>& _particles;
+  };
+
+  // Inserts a particle of this system's type or an object, respectively; see
+  // AmoebotSystem::insert. Particles of other types can't be inserted.
+  void insert(ParticleType* particle);
+  void insert(Object* object);
+
+  // Returns the particle at the specified index of particles.
+  ParticleType* particleAt(unsigned int i) const;
+
+  // Returns a view of all particles in this system as ParticleType.
+  ParticleRange typedParticles() const;
+
+ private:
+  // Converts a particle of this system to ParticleType, checking its type in
+  // debug builds only.
+  static ParticleType* typed(AmoebotParticle* particle);
+};
+
+template<class ParticleType>
+TypedAmoebotSystem<ParticleType>::ParticleIterator::ParticleIterator(
+    std::vector<AmoebotParticle*>::const_iterator it)
+  : _it(it) {}
+
+template<class ParticleType>
+ParticleType*
+TypedAmoebotSystem<ParticleType>::ParticleIterator::operator*() const {
+  return typed(*_it);
+}
+
+template<class ParticleType>
+typename TypedAmoebotSystem<ParticleType>::ParticleIterator&
+TypedAmoebotSystem<ParticleType>::ParticleIterator::operator++() {
+  ++_it;
+  return *this;
+}
+
+template<class ParticleType>
+bool TypedAmoebotSystem<ParticleType>::ParticleIterator::operator==(
+    const ParticleIterator& other) const {
+  return _it == other._it;
+}
+
+template<class ParticleType>
+bool TypedAmoebotSystem<ParticleType>::ParticleIterator::operator!=(
+    const ParticleIterator& other) const {
+  return _it != other._it;
+}
+
+template<class ParticleType>
+TypedAmoebotSystem<ParticleType>::ParticleRange::ParticleRange(
+    const std::vector<AmoebotParticle*>& particles)
+  : _particles(particles) {}
+
+template<class ParticleType>
+typename TypedAmoebotSystem<ParticleType>::ParticleIterator
+TypedAmoebotSystem<ParticleType>::ParticleRange::begin() const {
+  return ParticleIterator(_particles.begin());
+}
+
+template<class ParticleType>
+typename TypedAmoebotSystem<ParticleType>::ParticleIterator
+TypedAmoebotSystem<ParticleType>::ParticleRange::end() const {
+  return ParticleIterator(_particles.end());
+}
+
+template<class ParticleType>
+void TypedAmoebotSystem<ParticleType>::insert(ParticleType* particle) {
+  AmoebotSystem::insert(particle);
+}
+
+template<class ParticleType>
+void TypedAmoebotSystem<ParticleType>::insert(Object* object) {
+  AmoebotSystem::insert(object);
+}
+
+template<class ParticleType>
+ParticleType* TypedAmoebotSystem<ParticleType>::particleAt(
+    unsigned int i) const {
+  Q_ASSERT(i < particles.size());
+
+  return typed(particles[i]);
+}
+
+template<class ParticleType>
+typename TypedAmoebotSystem<ParticleType>::ParticleRange
+TypedAmoebotSystem<ParticleType>::typedParticles() const {
+  return ParticleRange(particles);
+}
+
+template<class ParticleType>
+ParticleType* TypedAmoebotSystem<ParticleType>::typed(
+    AmoebotParticle* particle) {
+  Q_ASSERT(dynamic_cast<ParticleType*>(particle) != nullptr);
+
+  return static_cast<ParticleType*>(particle);
+}
+
+#endif  // AMOEBOTSIM_CORE_TYPEDAMOEBOTSYSTEM_H_
@@ -4,4 +4,90 @@
 
 #include "helper/randomnumbergenerator.h"
 
-std::mt19937 RandomNumberGenerator::rng;
+#include <chrono>
+#include <random>
+
+namespace {
+
+// The default seed of the calling thread, or negative if there is none.
+thread_local int64_t defaultSeed = -1;
+
+// Expands a 64-bit seed into well-mixed state words, as recommended by the
+// xoshiro authors.
+uint64_t splitMix64(uint64_t& x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+}  // namespace
+
+RandomNumberGenerator::RandomNumberGenerator()
+{
+    seed(defaultSeed >= 0 ? static_cast<uint64_t>(defaultSeed) : entropySeed());
+}
+
+RandomNumberGenerator::RandomNumberGenerator(const uint64_t seed)
+{
+    this->seed(seed);
+}
+
+void RandomNumberGenerator::seed(const uint64_t seed)
+{
+    _seed = seed;
+    uint64_t x = seed;
+    for (auto& word : _state) {
+        word = splitMix64(x);
+    }
+}
+
+uint64_t RandomNumberGenerator::getSeed() const
+{
+    return _seed;
+}
+
+void RandomNumberGenerator::jump()
+{
+    static const uint64_t jumpPoly[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+                                        0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (const uint64_t poly : jumpPoly) {
+        for (int b = 0; b < 64; ++b) {
+            if (poly & (uint64_t(1) << b)) {
+                s0 ^= _state[0];
+                s1 ^= _state[1];
+                s2 ^= _state[2];
+                s3 ^= _state[3];
+            }
+            next();
+        }
+    }
+
+    _state[0] = s0;
+    _state[1] = s1;
+    _state[2] = s2;
+    _state[3] = s3;
+}
+
+int64_t RandomNumberGenerator::setDefaultSeed(const int64_t seed)
+{
+    const int64_t previous = defaultSeed;
+    defaultSeed = (seed >= 0) ? seed : -1;
+    return previous;
+}
+
+uint64_t RandomNumberGenerator::entropySeed()
+{
+    // Seeds are kept to 32 bits so that they survive a round trip through
+    // JavaScript numbers and the metrics JSON.
+    std::random_device device;
+    if (device.entropy() == 0) {
+        auto duration = std::chrono::high_resolution_clock::now().time_since_epoch();
+        return static_cast<uint32_t>(duration.count());
+    } else {
+        return std::uniform_int_distribution<uint32_t>()(device);
+    }
+}
@@ -2,83 +2,145 @@
  * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
  * notice can be found at the top of main/main.cpp. */
 
+// Defines a seedable pseudorandom number generator based on xoshiro256**
+// (Blackman and Vigna). Every AmoebotSystem owns one generator stream that its
+// particles draw from, so a run is fully determined by its seed and several
+// systems can be simulated at once without sharing state.
+
 #ifndef AMOEBOTSIM_HELPER_RANDOMNUMBERGENERATOR_H_
 #define AMOEBOTSIM_HELPER_RANDOMNUMBERGENERATOR_H_
 
-#include <algorithm>
-#include <chrono>
-#include <random>
+#include <cstdint>
+#include <iterator>
+#include <utility>
 
 class RandomNumberGenerator
 {
 public:
+    // Constructs a generator seeded with the current thread's default seed if
+    // one is set (see setDefaultSeed) and from entropy otherwise.
     RandomNumberGenerator();
+    explicit RandomNumberGenerator(const uint64_t seed);
+
+    // Reseeds the generator, restarting its stream. getSeed returns the seed
+    // the current stream was started from.
+    void seed(const uint64_t seed);
+    uint64_t getSeed() const;
+
+    // Advances the generator by 2^128 draws. Calling jump k times on copies of
+    // one generator yields k non-overlapping streams from a single seed.
+    void jump();
+
+    // Fixes the seed used by default-constructed generators on the calling
+    // thread, so that systems created afterwards on this thread are
+    // reproducible; a negative seed restores seeding from entropy. Returns the
+    // previous default seed (negative if there was none).
+    static int64_t setDefaultSeed(const int64_t seed);
 
-protected:
-    static int randInt(const int from, const int toNotIncluding);
-    static int randDir();
-    static float randFloat(const float from, const float toNotIncluding);
-    static double randDouble(const double from, const double toNotIncluding);
-    static bool randBool(const double trueProb = 0.5);
+    // Returns a fresh seed drawn from entropy.
+    static uint64_t entropySeed();
 
+    // Functions for drawing random values. randInt returns an integer in [from,
+    // toNotIncluding) without modulo bias, using a multiply-and-shift that only
+    // divides on the rare rejection path. randDir returns a direction in [0, 6).
+    int randInt(const int from, const int toNotIncluding);
+    int randDir();
+    float randFloat(const float from, const float toNotIncluding);
+    double randDouble(const double from, const double toNotIncluding);
+    bool randBool(const double trueProb = 0.5);
+
+    // Shuffles the given range uniformly at random (Fisher-Yates). Unlike
+    // std::shuffle, the resulting order is the same on every platform.
     template <class Iterator>
-    void shuffle(Iterator firxt, Iterator last);
+    void shuffle(Iterator first, Iterator last);
 
 private:
-    static std::mt19937 rng;
-};
+    // Returns the next 64 random bits and advances the generator.
+    uint64_t next();
 
-inline RandomNumberGenerator::RandomNumberGenerator()
-{
-    static bool initialized = false;
-    if(!initialized) {
-        uint32_t seed;
-        std::random_device device;
-        if(device.entropy() == 0) {
-            auto duration = std::chrono::high_resolution_clock::now() - std::chrono::high_resolution_clock::time_point::min();
-            seed = duration.count();
-        } else {
-            std::uniform_int_distribution<uint32_t> dist(std::numeric_limits<uint32_t>::min(),
-                                                         std::numeric_limits<uint32_t>::max());
-            seed = dist(device);
-        }
-        rng.seed(seed);
-        initialized = true;
-    }
-}
+    // Returns an integer in [0, range) for 0 < range <= 2^32.
+    uint32_t bounded(const uint64_t range);
+
+    static uint64_t rotl(const uint64_t x, const int k);
+
+    uint64_t _seed;
+    uint64_t _state[4];
+};
 
 inline int RandomNumberGenerator::randInt(const int from, const int toNotIncluding)
 {
-    std::uniform_int_distribution<int> dist(from, toNotIncluding - 1);
-    return dist(rng);
+    const uint64_t range = static_cast<int64_t>(toNotIncluding) - from;
+    return static_cast<int>(from + static_cast<int64_t>(bounded(range)));
 }
 
 inline int RandomNumberGenerator::randDir()
 {
-    return randInt(0, 6);
+    return static_cast<int>(bounded(6));
 }
 
 inline float RandomNumberGenerator::randFloat(const float from, const float toNotIncluding)
 {
-    std::uniform_real_distribution<float> dist(from, toNotIncluding);
-    return dist(rng);
+    // The top 24 bits fill a float's significand exactly.
+    const float unit = (next() >> 40) * (1.0f / 16777216.0f);
+    return from + unit * (toNotIncluding - from);
 }
 
 inline double RandomNumberGenerator::randDouble(const double from, const double toNotIncluding)
 {
-    std::uniform_real_distribution<double> dist(from, toNotIncluding);
-    return dist(rng);
+    // The top 53 bits fill a double's significand exactly.
+    const double unit = (next() >> 11) * (1.0 / 9007199254740992.0);
+    return from + unit * (toNotIncluding - from);
 }
 
 inline bool RandomNumberGenerator::randBool(const double trueProb)
 {
-    return (randFloat(0, 1) < trueProb);
+    return (randDouble(0, 1) < trueProb);
 }
 
 template <class Iterator>
 void RandomNumberGenerator::shuffle(Iterator first, Iterator last)
 {
-    std::shuffle(first, last, rng);
+    const auto n = std::distance(first, last);
+    for (auto i = n - 1; i > 0; --i) {
+        std::iter_swap(first + i, first + bounded(i + 1));
+    }
+}
+
+inline uint64_t RandomNumberGenerator::next()
+{
+    const uint64_t result = rotl(_state[1] * 5, 7) * 9;
+    const uint64_t t = _state[1] << 17;
+
+    _state[2] ^= _state[0];
+    _state[3] ^= _state[1];
+    _state[1] ^= _state[2];
+    _state[0] ^= _state[3];
+    _state[2] ^= t;
+    _state[3] = rotl(_state[3], 45);
+
+    return result;
+}
+
+inline uint32_t RandomNumberGenerator::bounded(const uint64_t range)
+{
+    // Lemire's method: the high half of a 32x32-bit product is uniform in
+    // [0, range) once the few low halves below 2^32 mod range are rejected.
+    uint64_t product = (next() >> 32) * range;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < range) {
+        const uint32_t threshold = static_cast<uint32_t>((uint64_t(1) << 32) % range);
+        while (low < threshold) {
+            product = (next() >> 32) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+
+    return static_cast<uint32_t>(product >> 32);
+}
+
+inline uint64_t RandomNumberGenerator::rotl(const uint64_t x, const int k)
+{
+    return (x << k) | (x >> (64 - k));
 }
 
 #endif  // AMOEBOTSIM_HELPER_RANDOMNUMBERGENERATOR_H_
@@ -24,6 +24,7 @@ Application::Application(int argc, char *argv[])
   auto qmlRoot = engine.rootObjects().first();
   auto vis = qmlRoot->findChild<VisItem*>();
   auto slider = qmlRoot->findChild<QObject*>("stepDurationSlider");
+  auto batchBox = qmlRoot->findChild<QObject*>("batchSizeBox");
   connect(vis, &VisItem::beforeRendering,
           [this, qmlRoot](){
             QMetaObject::invokeMethod(qmlRoot, "setMetrics", Q_ARG(QVariant, sim.metrics()));
@@ -79,6 +80,12 @@ Application::Application(int argc, char *argv[])
             QMetaObject::invokeMethod(slider, "setStepDuration", Q_ARG(QVariant, QVariant(ms)));
           }
   );
+  connect(batchBox, SIGNAL(batchSizeChanged(int)), &sim, SLOT(setBatchSize(int)));
+  connect(&sim, &Simulator::batchSizeChanged,
+          [batchBox](const int& size){
+            QMetaObject::invokeMethod(batchBox, "setBatchSize", Q_ARG(QVariant, QVariant(size)));
+          }
+  );
 
   // setup scripting
   scriptEngine = std::make_shared<ScriptEngine>(sim, vis, parameterModel->getAlgorithmList());
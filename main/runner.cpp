@@ -0,0 +1,250 @@
+/* Copyright (C) 2021 Joshua J. Daymude, Robert Gmyr, and Kristian Hinnenthal.
+ * The full GNU GPLv3 can be found in the LICENSE file, and the full copyright
+ * notice can be found at the top of main/main.cpp. */
+
+// Entry point for the headless runner, which instantiates a single algorithm
+// from the command line, runs it to termination (or a round limit) without any
+// GUI, and writes its metrics JSON to a file. Example:
+//
+//   AmoebotSimRunner -s 42 -r 1000 -o out.json compression 100 4.0
+//
+// Parameters follow the same order as in the GUI's parameter list; omitted
+// trailing parameters take their default values. With --replicas, the runner
+// instead runs that many independently seeded replicas of the instance in
+// parallel (see core/ensemble.h) and writes their merged metrics. With
+// --tempering (compression only), it runs one replica per given bias with
+// replica exchange (see alg/compressiontempering.h).
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QString>
+#include <QStringList>
+
+#include "alg/compressiontempering.h"
+#include "core/ensemble.h"
+#include "core/simulator.h"
+#include "helper/randomnumbergenerator.h"
+#include "ui/algorithm.h"
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("AmoebotSimRunner");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Runs an AmoebotSim algorithm without the "
+                                   "GUI and exports its metrics.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("algorithm", "Algorithm signature, e.g. "
+                               "compression.");
+  parser.addPositionalArgument("parameters", "Algorithm parameters in order.",
+                               "[parameters...]");
+  QCommandLineOption seedOption({"s", "seed"}, "Seed for the system's random "
+                                "number generator.", "seed");
+  QCommandLineOption roundsOption({"r", "rounds"}, "Stop after this many "
+                                  "rounds if the algorithm has not terminated.",
+                                  "rounds");
+  QCommandLineOption outputOption({"o", "output"}, "Path of the metrics JSON "
+                                  "file to write.", "path");
+  QCommandLineOption listOption({"l", "list"}, "List the available algorithms "
+                                "and their parameters.");
+  QCommandLineOption replicasOption({"n", "replicas"}, "Run this many replicas "
+                                    "in parallel; replica i uses seed + i.",
+                                    "replicas");
+  QCommandLineOption threadsOption({"j", "threads"}, "Number of worker threads "
+                                   "for replicas (default: all cores).",
+                                   "threads");
+  QCommandLineOption temperingOption({"t", "tempering"}, "Run compression "
+                                     "replicas at these comma-separated "
+                                     "lambdas with replica exchange.",
+                                     "lambdas");
+  QCommandLineOption epochOption({"e", "epoch-rounds"}, "Rounds between "
+                                 "replica exchanges (default: 10).", "rounds");
+  parser.addOption(seedOption);
+  parser.addOption(roundsOption);
+  parser.addOption(outputOption);
+  parser.addOption(listOption);
+  parser.addOption(replicasOption);
+  parser.addOption(threadsOption);
+  parser.addOption(temperingOption);
+  parser.addOption(epochOption);
+  parser.process(app);
+
+  AlgorithmList algs;
+  if (parser.isSet(listOption)) {
+    for (auto alg : algs.getAlgs()) {
+      std::printf("%s: %s\n", qPrintable(alg->getSignature()),
+                  qPrintable(alg->getParameterNames().join(", ")));
+    }
+    return 0;
+  }
+
+  QStringList args = parser.positionalArguments();
+  if (args.isEmpty()) {
+    parser.showHelp(1);
+  }
+  const QString signature = args.takeFirst();
+
+  bool ok = true;
+  int roundLimit = -1;
+  if (parser.isSet(roundsOption)) {
+    roundLimit = parser.value(roundsOption).toInt(&ok);
+    if (!ok || roundLimit < 0) {
+      std::fprintf(stderr, "rounds must be a non-negative integer\n");
+      return 1;
+    }
+  }
+  qint64 seed = -1;
+  if (parser.isSet(seedOption)) {
+    seed = parser.value(seedOption).toLongLong(&ok);
+    if (!ok || seed < 0) {
+      std::fprintf(stderr, "seed must be a non-negative integer\n");
+      return 1;
+    }
+  }
+  int numReplicas = 0;
+  if (parser.isSet(replicasOption)) {
+    numReplicas = parser.value(replicasOption).toInt(&ok);
+    if (!ok || numReplicas <= 0) {
+      std::fprintf(stderr, "replicas must be a positive integer\n");
+      return 1;
+    }
+  }
+  int numThreads = 0;
+  if (parser.isSet(threadsOption)) {
+    numThreads = parser.value(threadsOption).toInt(&ok);
+    if (!ok || numThreads <= 0) {
+      std::fprintf(stderr, "threads must be a positive integer\n");
+      return 1;
+    }
+  }
+
+  if (parser.isSet(temperingOption)) {
+    if (signature != "compression") {
+      std::fprintf(stderr, "tempering is only supported for compression\n");
+      return 1;
+    } else if (roundLimit < 0) {
+      std::fprintf(stderr, "tempering requires a round limit\n");
+      return 1;
+    } else if (numReplicas > 0) {
+      std::fprintf(stderr, "tempering and replicas are mutually exclusive\n");
+      return 1;
+    }
+
+    std::vector<double> lambdas;
+    for (const QString& value : parser.value(temperingOption).split(",")) {
+      lambdas.push_back(value.toDouble(&ok));
+      if (!ok || lambdas.back() <= 1) {
+        std::fprintf(stderr, "lambdas must be numbers > 1\n");
+        return 1;
+      }
+    }
+    if (lambdas.size() < 2) {
+      std::fprintf(stderr, "tempering requires at least two lambdas\n");
+      return 1;
+    }
+    std::sort(lambdas.begin(), lambdas.end());
+
+    int numParticles =
+        algs.getAlgBySignature(signature)->getParameterDefaults()[0].toInt();
+    if (!args.isEmpty() && !args[0].isEmpty()) {
+      numParticles = args[0].toInt(&ok);
+      if (!ok || numParticles <= 0) {
+        std::fprintf(stderr, "# particles must be > 0\n");
+        return 1;
+      }
+    }
+    int epochRounds = 10;
+    if (parser.isSet(epochOption)) {
+      epochRounds = parser.value(epochOption).toInt(&ok);
+      if (!ok || epochRounds <= 0) {
+        std::fprintf(stderr, "epoch rounds must be a positive integer\n");
+        return 1;
+      }
+    }
+
+    const uint64_t baseSeed = (seed >= 0) ? seed
+        : RandomNumberGenerator::entropySeed();
+    CompressionTempering tempering(numParticles, lambdas, baseSeed,
+                                   epochRounds);
+    tempering.run(roundLimit, numThreads);
+
+    if (parser.isSet(outputOption) &&
+        !tempering.exportMetrics(parser.value(outputOption))) {
+      std::fprintf(stderr, "could not write metrics to '%s'\n",
+                   qPrintable(parser.value(outputOption)));
+      return 1;
+    }
+
+    return 0;
+  }
+
+  Simulator sim;
+  bool failed = false;
+  for (auto alg : algs.getAlgs()) {
+    QObject::connect(alg, &Algorithm::log,
+                     [&failed](const QString msg, const bool isError) {
+      std::fprintf(stderr, "%s\n", qPrintable(msg));
+      failed = failed || isError;
+    });
+    QObject::connect(alg, &Algorithm::setSystem, &sim, &Simulator::setSystem);
+  }
+
+  if (!algs.instantiate(signature, args, seed)) {
+    std::fprintf(stderr, "unknown algorithm '%s'; use --list to see the "
+                 "available algorithms\n", qPrintable(signature));
+    return 1;
+  } else if (failed || sim.getSystem() == nullptr) {
+    return 1;
+  }
+
+  if (numReplicas > 0) {
+    // The instance above only served to validate the parameters once; each
+    // replica builds its own from a private AlgorithmList, since the shared
+    // one's signals are connected to this thread's simulator.
+    auto factory = [&signature, &args](uint64_t replicaSeed) {
+      AlgorithmList replicaAlgs;
+      std::shared_ptr<System> system;
+      for (auto alg : replicaAlgs.getAlgs()) {
+        QObject::connect(alg, &Algorithm::setSystem,
+                         [&system](std::shared_ptr<System> s) {
+          system = s;
+        });
+      }
+      replicaAlgs.instantiate(signature, args, replicaSeed);
+      return system;
+    };
+
+    const uint64_t baseSeed = (seed >= 0) ? seed
+        : RandomNumberGenerator::entropySeed();
+    Ensemble ensemble(signature, factory, numReplicas, baseSeed, roundLimit);
+    if (!ensemble.run(numThreads)) {
+      std::fprintf(stderr, "some replicas could not be instantiated\n");
+      return 1;
+    }
+
+    if (parser.isSet(outputOption) &&
+        !ensemble.exportMetrics(parser.value(outputOption))) {
+      std::fprintf(stderr, "could not write metrics to '%s'\n",
+                   qPrintable(parser.value(outputOption)));
+      return 1;
+    }
+
+    return 0;
+  }
+
+  sim.runUntilTermination(roundLimit);
+
+  if (parser.isSet(outputOption) &&
+      !sim.exportMetrics(parser.value(outputOption))) {
+    std::fprintf(stderr, "could not write metrics to '%s'\n",
+                 qPrintable(parser.value(outputOption)));
+    return 1;
+  }
+
+  return 0;
+}
@@ -390,6 +390,40 @@ ApplicationWindow {
       }
     }
 
+    RowLayout {
+      id: batchSizeRow
+      Layout.bottomMargin: 15
+
+      Rectangle {
+        Layout.preferredWidth: 130
+        Text {
+          anchors.left: parent.left
+          anchors.verticalCenter: parent.verticalCenter
+          text: "Batch Size (0 = auto):"
+        }
+      }
+
+      // Sets how many activations are executed per step. Setting the value
+      // from the simulator doesn't change it when it already matches, so the
+      // signal/setter round trip between the two ends after one pass.
+      SpinBox {
+        id: batchSizeBox
+        objectName: "batchSizeBox"
+        Layout.fillWidth: true
+        minimumValue: 0
+        maximumValue: 1000000
+        value: 1
+
+        signal batchSizeChanged(int value)
+
+        onValueChanged: batchSizeChanged(value)
+
+        function setBatchSize(size) {
+          value = size
+        }
+      }
+    }
+
     RowLayout {
       id: controlButtonRow
       spacing: 5
@@ -8,6 +8,7 @@
 #include <QString>
 #include <QTextStream>
 
+#include "helper/randomnumbergenerator.h"
 #include "script/scriptinterface.h"
 
 ScriptEngine::ScriptEngine(Simulator& sim, VisItem* vis, AlgorithmList* algList)
@@ -26,6 +27,12 @@ ScriptEngine::ScriptEngine(Simulator& sim, VisItem* vis, AlgorithmList* algList)
     auto algObject = engine.newQObject(alg);
     engine.globalObject().setProperty(alg->getSignature(), algObject);
     engine.evaluate("this[\"" + alg->getSignature() + "\"] = " + alg->getSignature() + "[\"instantiate\"]");
+
+    // A seed set by the script applies to the next instantiation only (see
+    // ScriptInterface::setSeed), so clear it once the new system exists.
+    connect(alg, &Algorithm::setSystem, this, []() {
+      RandomNumberGenerator::setDefaultSeed(-1);
+    });
   }
 }
 
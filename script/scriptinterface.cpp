@@ -6,10 +6,12 @@
 
 #include <QDateTime>
 #include <QFile>
+#include <QMutexLocker>
 #include <QTextStream>
 
 #include "alg/shapeformation.h"
 #include "core/node.h"
+#include "helper/randomnumbergenerator.h"
 
 ScriptInterface::ScriptInterface(ScriptEngine &engine, Simulator& sim,
                                  VisItem *vis)
@@ -54,6 +56,22 @@ void ScriptInterface::setStepDuration(const int ms) {
   }
 }
 
+void ScriptInterface::setBatchSize(const int size) {
+  if (size < 0) {
+    log("Batch size must be non-negative", true);
+  } else {
+    sim.setBatchSize(size);
+  }
+}
+
+void ScriptInterface::setBatchBudget(const int ms) {
+  if (ms <= 0) {
+    log("Batch budget must be positive", true);
+  } else {
+    sim.setBatchBudget(ms);
+  }
+}
+
 void ScriptInterface::runUntilTermination() {
   sim.runUntilTermination();
 }
@@ -72,20 +90,46 @@ void ScriptInterface::exportMetrics() {
 }
 
 QVariant ScriptInterface::getMetric(QString name, bool history) {
-  for (const auto& c : sim.getSystem()->getCounts()) {
+  // The worker thread records metrics while running, so read them under the
+  // system's mutex.
+  std::shared_ptr<System> system = sim.getSystem();
+  QMutexLocker locker(&system->mutex);
+  for (const auto& c : system->getCounts()) {
     if (c->_name == name) {
-      return history ? QVariant::fromValue(c->_history) : c->_value;
+      if (!history) {
+        return c->_value;
+      }
+
+      // The script engine only converts lists of some types to arrays, which
+      // excludes 64-bit integers, so convert the history element by element.
+      QVariantList values;
+      values.reserve(c->_history.size());
+      for (const quint64 value : c->_history) {
+        values.append(value);
+      }
+      return values;
     }
   }
-  for (const auto& m : sim.getSystem()->getMeasures()) {
+  for (const auto& m : system->getMeasures()) {
     if (m->_name == name) {
       return history ? QVariant::fromValue(m->_history) : m->_history.back();
     }
   }
+  locker.unlock();
   log("no metrics with given name exist", true);
   return QVariant();
 }
 
+void ScriptInterface::setSeed(const double seed) {
+  RandomNumberGenerator::setDefaultSeed(static_cast<qint64>(seed));
+}
+
+double ScriptInterface::getSeed() {
+  std::shared_ptr<System> system = sim.getSystem();
+  QMutexLocker locker(&system->mutex);
+  return system->getSeed();
+}
+
 void ScriptInterface::setWindowSize(int width, int height) {
   if(vis != nullptr) {
     vis->setWindowSize(width, height);
@@ -121,8 +165,14 @@ void ScriptInterface::filmSimulation(QString filePath, const int stepLimit) {
     temp = temp % 10;
   }
 
+  std::shared_ptr<System> system = sim.getSystem();
+  auto hasTerminated = [&system]() {
+    QMutexLocker locker(&system->mutex);
+    return system->hasTerminated();
+  };
+
   int i = 0;
-  while(!sim.getSystem()->hasTerminated() && i < stepLimit) {
+  while(!hasTerminated() && i < stepLimit) {
     emit vis->beforeRendering();  // Updates GUI #rounds and #movements labels.
     saveScreenshot(filePath + pad(i,fnameLen) + QString(".png"));
     step();
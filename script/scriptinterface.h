@@ -32,10 +32,15 @@ class ScriptInterface : public QObject {
   // Simulator flow commands. step executes a single particle activation.
   // setStepDuration sets the simulator's delay between particle activations to
   // the given value; if this value is negative, an error is logged and the step
-  // duration is set to 0. runUntilTermination runs the current algorithm
+  // duration is set to 0. setBatchSize sets the number of activations the
+  // simulator executes per step, with 0 adapting this number to the time budget
+  // set by setBatchBudget; negative sizes and non-positive budgets are logged
+  // as errors and ignored. runUntilTermination runs the current algorithm
   // instance until its hasTerminated function returns true.
   void step();
   void setStepDuration(const int ms);
+  void setBatchSize(const int size);
+  void setBatchBudget(const int ms);
   void runUntilTermination();
 
   // Simulator metrics commands. getNumParticles and getNumObjects return the
@@ -49,6 +54,13 @@ class ScriptInterface : public QObject {
   void exportMetrics();
   QVariant getMetric(QString name, bool history = false);
 
+  // Random number generator commands. setSeed fixes the seed of the next
+  // algorithm instance created so that script runs are reproducible; a
+  // negative seed restores seeding from entropy. getSeed returns the seed of
+  // the current instance's generator.
+  void setSeed(const double seed);
+  double getSeed();
+
   // Visualization commands. focusOn centers the window at the given (x,y) node.
   // setZoom sets the zoom level of the window. saveScreenshot saves the current
   // window as a .png in the specified location; if no filepath is provided, a
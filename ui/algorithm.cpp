@@ -11,6 +11,7 @@
 #include "alg/demo/tokendemo.h"
 #include "alg/aggregation.h"
 #include "alg/compression.h"
+#include "alg/compressionbitboard.h"
 #include "alg/edfhexagonformation.h"
 #include "alg/edfleaderelectionbyerosion.h"
 #include "alg/energyshape.h"
@@ -20,6 +21,7 @@
 #include "alg/leaderelection.h"
 #include "alg/leaderelectionbyerosion.h"
 #include "alg/shapeformation.h"
+#include "helper/randomnumbergenerator.h"
 
 Algorithm::Algorithm(QString name, QString signature)
     : _name(name),
@@ -162,13 +164,22 @@ void AggregationAlg::instantiate(const int numParticles, const QString mode,
 CompressionAlg::CompressionAlg() : Algorithm("Compression", "compression") {
   addParameter("# Particles", "100");
   addParameter("Lambda", "4.0");
+  addParameter("Engine", "r");
 }
 
-void CompressionAlg::instantiate(const int numParticles, const double lambda) {
+void CompressionAlg::instantiate(const int numParticles, const double lambda,
+                                 const QString engine) {
   if (numParticles <= 0) {
     emit log("# particles must be > 0", true);
+  } else if (engine != "r" && engine != "v" && engine != "b" &&
+             engine != "c") {
+    emit log("only accepted engines are: r, v, b, c", true);
+  } else if (engine == "r" || engine == "v") {
+    emit setSystem(std::make_shared<CompressionSystem>(numParticles, lambda,
+                                                       engine == "v"));
   } else {
-    emit setSystem(std::make_shared<CompressionSystem>(numParticles, lambda));
+    emit setSystem(std::make_shared<BitboardCompressionSystem>(
+        numParticles, lambda, engine == "c"));
   }
 }
 
@@ -423,7 +434,10 @@ AlgorithmList::AlgorithmList() {
 }
 
 AlgorithmList::~AlgorithmList() {
-  _algorithms.erase(_algorithms.begin(), _algorithms.end());
+  for (auto alg : _algorithms) {
+    delete alg;
+  }
+  _algorithms.clear();
 }
 
 std::vector<Algorithm*> AlgorithmList::getAlgs() {
@@ -488,3 +502,103 @@ QStringList AlgorithmList::getParameterDefaults(QString algName) const {
 
   return defaults;
 }
+
+Algorithm* AlgorithmList::getAlgBySignature(QString signature) const {
+  for (auto alg : _algorithms) {
+    if (alg->getSignature().compare(signature) == 0) {
+      return alg;
+    }
+  }
+
+  return nullptr;
+}
+
+bool AlgorithmList::instantiate(QString signature, QStringList params,
+                                const qint64 seed) const {
+  Algorithm* alg = getAlgBySignature(signature);
+  if (alg == nullptr) {
+    return false;
+  }
+
+  // Fill in defaults for any parameters that were omitted or left empty.
+  QStringList defaults = alg->getParameterDefaults();
+  for (int i = 0; i < defaults.size(); ++i) {
+    if (i >= params.size()) {
+      params.append(defaults[i]);
+    } else if (params[i].compare("") == 0) {
+      params[i] = defaults[i];
+    }
+  }
+
+  // Pin the seed of the new system's generator if one is given. Otherwise, a
+  // seed set by a script (see ScriptInterface::setSeed) may still be pending.
+  if (seed >= 0) {
+    RandomNumberGenerator::setDefaultSeed(seed);
+  }
+
+  bool recognized = true;
+  if (signature == "discodemo") {
+    dynamic_cast<DiscoDemoAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toInt());
+  } else if (signature == "metricsdemo") {
+    dynamic_cast<MetricsDemoAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toInt());
+  } else if (signature == "ballroomdemo") {
+    dynamic_cast<BallroomDemoAlg*>(alg)->
+        instantiate(params[0].toInt());
+  } else if (signature == "tokendemo") {
+    dynamic_cast<TokenDemoAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toInt());
+  } else if (signature == "dynamicdemo") {
+    dynamic_cast<DynamicDemoAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toDouble(),
+                    params[2].toDouble());
+  } else if (signature == "aggregation") {
+    dynamic_cast<AggregationAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1], params[2].toDouble());
+  } else if (signature == "compression") {
+    dynamic_cast<CompressionAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toDouble(), params[2]);
+  } else if (signature == "edfhexagonformation") {
+    dynamic_cast<EDFHexagonFormationAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toInt(), params[2].toDouble(),
+                    params[3].toInt(), params[4].toInt(), params[5].toInt());
+  } else if (signature == "edfleaderelectionbyerosion") {
+    dynamic_cast<EDFLeaderElectionByErosionAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toInt(), params[2].toInt(),
+                    params[3].toInt(), params[4].toInt());
+  } else if (signature == "energyshape") {
+    dynamic_cast<EnergyShapeAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toInt(), params[2].toDouble(),
+                    params[3].toDouble(), params[4].toDouble(),
+                    params[5].toDouble());
+  } else if (signature == "energysharing") {
+    dynamic_cast<EnergySharingAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toInt(), params[2].toInt(),
+                    params[3].toDouble(), params[4].toDouble(),
+                    params[5].toDouble());
+  } else if (signature == "hexagonformation") {
+    dynamic_cast<HexagonFormationAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toDouble());
+  } else if (signature == "infobjcoating") {
+    dynamic_cast<InfObjCoatingAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toDouble());
+  } else if (signature == "leaderelection") {
+    dynamic_cast<LeaderElectionAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toDouble());
+  } else if (signature == "leaderelectionbyerosion") {
+    dynamic_cast<LeaderElectionByErosionAlg*>(alg)->
+        instantiate(params[0].toInt());
+  } else if (signature == "shapeformation") {
+    dynamic_cast<ShapeFormationAlg*>(alg)->
+        instantiate(params[0].toInt(), params[1].toDouble(), params[2]);
+  } else {
+    recognized = false;
+  }
+
+  // Either way, the seed applies to this instantiation only, so that later
+  // ones with an empty seed draw a fresh one.
+  RandomNumberGenerator::setDefaultSeed(-1);
+
+  return recognized;
+}
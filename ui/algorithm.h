@@ -123,7 +123,8 @@ class CompressionAlg : public Algorithm {
   CompressionAlg();
 
  public slots:
-  void instantiate(const int numParticles = 100, const double lambda = 4.0);
+  void instantiate(const int numParticles = 100, const double lambda = 4.0,
+                   const QString engine = "r");
 };
 
 // Energy Distribution Framework + Hexagon Formation (canonical).
@@ -247,8 +248,11 @@ class AlgorithmList {
   // Returns a list of all the algorithms in this list.
   std::vector<Algorithm*> getAlgs();
 
-  // Returns the algorithm object of the given algorithm.
+  // Returns the algorithm object of the given algorithm. getAlgBySignature
+  // does the same, but looks the algorithm up by its signature instead of its
+  // name; both return nullptr if no such algorithm exists.
   Algorithm* getAlg(QString algName) const;
+  Algorithm* getAlgBySignature(QString signature) const;
 
   // Returns a list of all the algorithm's names in this list.
   QStringList getAlgNames() const;
@@ -261,6 +265,17 @@ class AlgorithmList {
   QStringList getParameterNames(QString algName) const;
   QStringList getParameterDefaults(QString algName) const;
 
+  // Converts the given string parameters to the types expected by the
+  // algorithm with the given signature and calls its instantiate function.
+  // Missing or empty parameters are replaced by their defaults. A non-negative
+  // seed fixes the new system's random number generator, making the run
+  // reproducible; otherwise the generator is seeded as usual, i.e., with a seed
+  // set by a script if one is pending and from entropy if not. Either way, no
+  // seed carries over to later instantiations. Returns false if no algorithm
+  // with the given signature exists.
+  bool instantiate(QString signature, QStringList params,
+                   const qint64 seed = -1) const;
+
  private:
   std::vector<Algorithm*> _algorithms;
 };
@@ -36,11 +36,12 @@ class ParameterListModel : public QStringListModel {
 
  public slots:
   // Updates this model's internal string list to be the list of parameter names
-  // for the given algorithm.
+  // for the given algorithm, followed by a seed for its random number
+  // generator.
   void updateAlgParameters(QString algName);
 
   // Extracts the parameter values and creates an instance of the corresponding
-  // algorithm (according to algName).
+  // algorithm (according to algName). An empty seed draws one from entropy.
   void createSystem(QString algName);
 
  private:
@@ -33,15 +33,18 @@ void VisItem::systemChanged(std::shared_ptr<System> _system) {
 }
 
 void VisItem::focusOnCenterOfMass() {
-  QMutexLocker locker(&system->mutex);
-  if (system == nullptr || system->size() == 0) {
+  if (system == nullptr) {
+    return;
+  }
+  auto snapshot = system->snapshots.latest();
+  if (snapshot == nullptr || snapshot->particles.empty()) {
     return;
   }
 
   QPointF sum;
   int numMassPoints = 0;
 
-  for (const Particle& p : *system) {
+  for (const Particle& p : snapshot->particles) {
     sum = sum + nodeToWorldCoord(p.head);
     numMassPoints++;
     if (p.globalTailDir != -1) {
@@ -50,8 +53,8 @@ void VisItem::focusOnCenterOfMass() {
     }
   }
 
-  for(const Object* obj: system->getObjects()) {
-      sum = sum + nodeToWorldCoord(obj->_node);
+  for(const Object& obj: snapshot->objects) {
+      sum = sum + nodeToWorldCoord(obj._node);
       numMassPoints++;
   }
 
@@ -108,12 +111,15 @@ void VisItem::paint() {
 
   drawGrid();
 
+  // Draw the latest published snapshot rather than the live system so that
+  // rendering never waits for the simulation thread.
   if (system != nullptr) {
-    QMutexLocker locker(&system->mutex);
+    auto snapshot = system->snapshots.latest();
+    if (snapshot != nullptr) {
+      drawParticles(*snapshot);
 
-    drawParticles();
-
-    drawObjects();
+      drawObjects(*snapshot);
+    }
   }
 }
 
@@ -162,27 +168,27 @@ void VisItem::drawGrid() {
   glfn->glEnd();
 }
 
-void VisItem::drawParticles() {
+void VisItem::drawParticles(const SystemSnapshot& snapshot) {
   particleTex->bind();
   glfn->glBegin(GL_QUADS);
 
   // Draw particle marks, then particles, then borders, then border points.
-  for (const Particle& p : *system) {
+  for (const Particle& p : snapshot.particles) {
     if (view.includes(nodeToWorldCoord(p.head))) {
       drawMarks(p);
     }
   }
-  for (const Particle& p : *system) {
+  for (const Particle& p : snapshot.particles) {
     if (view.includes(nodeToWorldCoord(p.head))) {
       drawParticle(p);
     }
   }
-  for (const Particle& p : *system) {
+  for (const Particle& p : snapshot.particles) {
     if (view.includes(nodeToWorldCoord(p.head))) {
       drawBorders(p);
     }
   }
-  for (const Particle& p : *system) {
+  for (const Particle& p : snapshot.particles) {
     if (view.includes(nodeToWorldCoord(p.head))) {
       drawBorderPoints(p);
     }
@@ -259,12 +265,11 @@ void VisItem::drawFromParticleTex(int index, const QPointF& pos) {
   glfn->glVertex2d(pos.x() - halfQuadSideLength, pos.y() + halfQuadSideLength);
 }
 
-void VisItem::drawObjects() {
+void VisItem::drawObjects(const SystemSnapshot& snapshot) {
   glfn->glBegin(GL_QUADS);
 
-  std::deque<Object*> objects = system->getObjects();
-  for(auto t : objects) {
-      drawObject(*t);
+  for(const Object& t : snapshot.objects) {
+      drawObject(t);
   }
 
   glfn->glEnd();
@@ -307,12 +312,14 @@ void VisItem::mousePressEvent(QMouseEvent* e) {
       translating = false;
       auto clickedNode = worldCoordToNode(windowCoordToWorldCoord(e->localPos()));
       QString text = "";
+      QMutexLocker locker(&system->mutex);
       for (const auto& p : *system) {
         if (p.head == clickedNode || (p.isExpanded() && p.tail() == clickedNode)) {
           text = p.inspectionText();
           break;
         }
       }
+      locker.unlock();
       while (text.endsWith('\n')) {
         text.chop(1);
       }
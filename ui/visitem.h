@@ -17,6 +17,7 @@
 #include "core/node.h"
 #include "core/object.h"
 #include "core/particle.h"
+#include "core/snapshot.h"
 #include "core/system.h"
 #include "ui/glitem.h"
 #include "ui/view.h"
@@ -49,13 +50,13 @@ class VisItem : public GLItem {
   void setupCamera();
 
   void drawGrid();
-  void drawParticles();
+  void drawParticles(const SystemSnapshot& snapshot);
   void drawMarks(const Particle& p);
   void drawParticle(const Particle& p);
   void drawBorders(const Particle& p);
   void drawBorderPoints(const Particle& p);
   void drawFromParticleTex(int index, const QPointF& pos);
-  void drawObjects();
+  void drawObjects(const SystemSnapshot& snapshot);
   void drawObject(const Object& t);
 
   static QPointF nodeToWorldCoord(const Node& node);